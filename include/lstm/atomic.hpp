@@ -3,6 +3,7 @@
 
 #include <lstm/read_only.hpp>
 #include <lstm/read_write.hpp>
+#include <lstm/snapshot_isolated.hpp>
 
 LSTM_DETAIL_BEGIN
     struct atomic_fn
@@ -10,6 +11,25 @@ LSTM_DETAIL_BEGIN
         /*************
          * read_write
          *************/
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(is_transact_function<Func&&, transaction, Args&&...>())>
+        LSTM_ALWAYS_INLINE transact_result<Func, transaction, Args&&...>
+        operator()(thread_data& tls_td, transaction_domain& domain, Func&& func, Args&&... args)
+            const
+        {
+            return ::lstm::read_write(tls_td, domain, (Func &&) func, (Args &&) args...);
+        }
+
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(is_transact_function<Func&&, transaction, Args&&...>())>
+        LSTM_ALWAYS_INLINE transact_result<Func, transaction, Args&&...>
+        operator()(transaction_domain& domain, Func&& func, Args&&... args) const
+        {
+            return ::lstm::read_write(domain, (Func &&) func, (Args &&) args...);
+        }
+
         template<typename Func,
                  typename... Args,
                  LSTM_REQUIRES_(is_transact_function<Func&&, transaction, Args&&...>())>
@@ -31,6 +51,27 @@ LSTM_DETAIL_BEGIN
         /************
          * read_only
          ************/
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(!is_transact_function<Func&&, transaction, Args&&...>()),
+                 LSTM_REQUIRES_(is_transact_function<Func&&, read_transaction, Args&&...>())>
+        LSTM_ALWAYS_INLINE transact_result<Func, read_transaction, Args&&...>
+        operator()(thread_data& tls_td, transaction_domain& domain, Func&& func, Args&&... args)
+            const
+        {
+            return ::lstm::read_only(tls_td, domain, (Func &&) func, (Args &&) args...);
+        }
+
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(!is_transact_function<Func&&, transaction, Args&&...>()),
+                 LSTM_REQUIRES_(is_transact_function<Func&&, read_transaction, Args&&...>())>
+        LSTM_ALWAYS_INLINE transact_result<Func, read_transaction, Args&&...>
+        operator()(transaction_domain& domain, Func&& func, Args&&... args) const
+        {
+            return ::lstm::read_only(domain, (Func &&) func, (Args &&) args...);
+        }
+
         template<typename Func,
                  typename... Args,
                  LSTM_REQUIRES_(!is_transact_function<Func&&, transaction, Args&&...>()),
@@ -82,6 +123,7 @@ LSTM_DETAIL_BEGIN
 
         template<typename Func,
                  typename... Args,
+                 LSTM_REQUIRES_(!std::is_base_of<transaction_domain, uncvref<Func>>{}),
                  LSTM_REQUIRES_(!is_transact_function<Func&&, transaction, Args&&...>()),
                  LSTM_REQUIRES_(!is_transact_function<Func&&, read_transaction, Args&&...>())>
         void operator()(Func&&, Args&&...) const
@@ -0,0 +1,150 @@
+#ifndef LSTM_CLOCK_HPP
+#define LSTM_CLOCK_HPP
+
+#include <lstm/detail/lstm_fwd.hpp>
+
+#include <atomic>
+
+// clang-format off
+#if defined(__x86_64__) && defined(__GNUC__)
+    #define LSTM_TSC_CLOCK_SUPPORT
+    #include <x86intrin.h>
+#endif
+// clang-format on
+
+// clock policies for transaction_domain. each policy is a set of static functions over the domains
+// clock word:
+//  - get_clock: returns the version a new transaction starts at
+//  - fetch_and_bump_clock: called by a committing transaction after it has locked its write set.
+//    returns the sync epoch, and the transaction's writes are published at sync epoch + 1
+//  - advance_past: called after a transaction fails, and before waiting on a grace period. ensures
+//    transactions starting afterwards are given a version greater than the passed in epoch
+//  - ordered_commits: true if every commit is ordered after the transactions that got their
+//    version from the clock before the commit got its sync epoch
+LSTM_BEGIN
+    // TL2 GV1: every commit increments the clock
+    struct gv1_clock
+    {
+        static constexpr bool ordered_commits = true;
+
+        static epoch_t get_clock(const std::atomic<epoch_t>& clock) noexcept
+        {
+            return clock.load(LSTM_ACQUIRE);
+        }
+
+        static epoch_t fetch_and_bump_clock(std::atomic<epoch_t>& clock) noexcept
+        {
+            return clock.fetch_add(1, LSTM_RELEASE);
+        }
+
+        static void advance_past(std::atomic<epoch_t>&, const epoch_t) noexcept {}
+    };
+
+    // TL2 GV4: commits make a single attempt at incrementing the clock. a commit that loses the
+    // race publishes one past the winner's clock value instead of retrying. the clock is then
+    // behind that write version, so failed transactions advance it as in GV5
+    struct gv4_clock
+    {
+        static constexpr bool ordered_commits = false;
+
+        static epoch_t get_clock(const std::atomic<epoch_t>& clock) noexcept
+        {
+            return clock.load(LSTM_ACQUIRE);
+        }
+
+        static epoch_t fetch_and_bump_clock(std::atomic<epoch_t>& clock) noexcept
+        {
+            epoch_t expected = clock.load(LSTM_RELAXED);
+            // on failure, expected holds the clock value another commit bumped it to. the sync
+            // epoch must not be less than that, as a reader could already be running at it
+            clock.compare_exchange_strong(expected, expected + 1, LSTM_RELEASE, LSTM_ACQUIRE);
+            return expected;
+        }
+
+        static void advance_past(std::atomic<epoch_t>& clock, epoch_t epoch) noexcept
+        {
+            if (clock.load(LSTM_RELAXED) == epoch)
+                clock.compare_exchange_strong(epoch, epoch + 1, LSTM_RELEASE, LSTM_RELAXED);
+        }
+    };
+
+    // TL2 GV5: commits publish at clock + 1 without writing to the clock. transactions that fail
+    // bump the clock instead, so the clock only sees writes under contention, at the cost of some
+    // false aborts
+    struct gv5_clock
+    {
+        static constexpr bool ordered_commits = false;
+
+        static epoch_t get_clock(const std::atomic<epoch_t>& clock) noexcept
+        {
+            return clock.load(LSTM_ACQUIRE);
+        }
+
+        static epoch_t fetch_and_bump_clock(std::atomic<epoch_t>& clock) noexcept
+        {
+            return clock.load(LSTM_ACQUIRE);
+        }
+
+        // no version in the domain is ever more than one greater than the clock
+        static void advance_past(std::atomic<epoch_t>& clock, epoch_t epoch) noexcept
+        {
+            if (clock.load(LSTM_RELAXED) == epoch)
+                clock.compare_exchange_strong(epoch, epoch + 1, LSTM_RELEASE, LSTM_RELAXED);
+        }
+    };
+
+    // TL2 GV6: behaves as GV1 for one in every `Period` commits per thread, and GV5 otherwise. this
+    // bounds the number of false aborts GV5 causes in read heavy workloads
+    template<unsigned Period = 32>
+    struct gv6_clock
+    {
+        static_assert(Period && (Period & (Period - 1)) == 0, "Period must be a power of two");
+
+        static constexpr bool ordered_commits = false;
+
+        static epoch_t get_clock(const std::atomic<epoch_t>& clock) noexcept
+        {
+            return clock.load(LSTM_ACQUIRE);
+        }
+
+        static epoch_t fetch_and_bump_clock(std::atomic<epoch_t>& clock) noexcept
+        {
+            static LSTM_THREAD_LOCAL unsigned commit_count = 0;
+            if ((++commit_count & (Period - 1)) == 0)
+                return gv1_clock::fetch_and_bump_clock(clock);
+            return gv5_clock::fetch_and_bump_clock(clock);
+        }
+
+        static void advance_past(std::atomic<epoch_t>& clock, const epoch_t epoch) noexcept
+        {
+            gv5_clock::advance_past(clock, epoch);
+        }
+    };
+
+#ifdef LSTM_TSC_CLOCK_SUPPORT
+    // versions are read from the timestamp counter, and the clock word is never touched. requires
+    // an invariant TSC that is synchronized across all cores
+    struct tsc_clock
+    {
+        static constexpr bool ordered_commits = true;
+
+        static epoch_t get_clock(const std::atomic<epoch_t>&) noexcept
+        {
+            // lfence keeps the read from moving across surrounding loads and stores
+            _mm_lfence();
+            const epoch_t result = __rdtsc();
+            _mm_lfence();
+            return result;
+        }
+
+        static epoch_t fetch_and_bump_clock(std::atomic<epoch_t>& clock) noexcept
+        {
+            return get_clock(clock) - 1;
+        }
+
+        static void advance_past(std::atomic<epoch_t>&, const epoch_t) noexcept {}
+    };
+#endif /* LSTM_TSC_CLOCK_SUPPORT */
+LSTM_END
+
+#endif /* LSTM_CLOCK_HPP */
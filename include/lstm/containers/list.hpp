@@ -37,6 +37,8 @@ LSTM_BEGIN
         using Alloc        = detail::rebind_to<Alloc_, node_t>;
         using alloc_traits = std::allocator_traits<Alloc>;
 
+        // nullptr for the default domain, which keeps the default constructors constexpr
+        transaction_domain*                                   domain_{nullptr};
         lstm::var<node_t*, detail::rebind_to<Alloc, node_t*>> head{nullptr};
         lstm::var<word, detail::rebind_to<Alloc, word>>       size_{0};
 
@@ -99,17 +101,32 @@ LSTM_BEGIN
 
     public:
         constexpr list() noexcept(std::is_nothrow_default_constructible<Alloc>{}) = default;
+
+        explicit list(transaction_domain& domain) noexcept(
+            std::is_nothrow_default_constructible<Alloc>{})
+            : domain_(&domain)
+        {
+        }
+
         constexpr list(const Alloc_& alloc) noexcept(
             std::is_nothrow_constructible<Alloc, const Alloc_&>{})
             : Alloc(alloc)
         {
         }
 
+        list(transaction_domain& domain,
+             const Alloc_&       alloc) noexcept(std::is_nothrow_constructible<Alloc,
+                                                                          const Alloc_&>{})
+            : Alloc(alloc)
+            , domain_(&domain)
+        {
+        }
+
         ~list() { destroy_deallocate_sublist(alloc(), head.unsafe_get()); }
 
         void clear()
         {
-            lstm::atomic([&](const transaction tx) {
+            lstm::atomic(domain(), [&](const transaction tx) {
                 size_.set(tx, 0);
                 auto root = head.get(tx);
                 head.set(tx, nullptr);
@@ -126,20 +143,25 @@ LSTM_BEGIN
         {
             thread_data& tls_td   = tls_thread_data();
             node_t*      new_head = lstm::allocate_construct(tls_td, alloc(), (Us &&) us...);
-            lstm::atomic(tls_td, [&](const transaction tx) {
+            lstm::atomic(tls_td, domain(), [&](const transaction tx) {
                 auto head_ = head.get(tx);
                 new_head->next_.unsafe_set(head_);
 
                 if (head_)
                     head_->prev_.set(tx, (void*)new_head);
-                size_.set(tx, size_.get(tx) + 1);
+                size_.add(tx, 1);
                 head.set(tx, new_head);
             });
         }
 
         word size() const
         {
-            return lstm::atomic([&](const transaction tx) { return size_.get(tx); });
+            return lstm::atomic(domain(), [&](const transaction tx) { return size_.get(tx); });
+        }
+
+        transaction_domain& domain() const noexcept
+        {
+            return domain_ ? *domain_ : default_domain();
         }
     };
 LSTM_END
@@ -20,10 +20,11 @@ LSTM_DETAIL_BEGIN
     {
         lstm::var<Key, rebind_to<Alloc, Key>>     key;
         lstm::var<Value, rebind_to<Alloc, Value>> value;
-        lstm::var<void*, rebind_to<Alloc, void*>> parent_;
         lstm::var<void*, rebind_to<Alloc, void*>> left_;
         lstm::var<void*, rebind_to<Alloc, void*>> right_;
-        lstm::var<color, rebind_to<Alloc, color>> color_;
+        // the parent, with the color in its low bit. the two are mostly read and written together
+        // while rebalancing, which then costs one read set entry and one lock per node
+        lstm::var<std::uintptr_t, rebind_to<Alloc, std::uintptr_t>> parent_color_;
 
         template<typename T,
                  typename U,
@@ -35,12 +36,52 @@ LSTM_DETAIL_BEGIN
                                  && std::is_nothrow_constructible<Value, U&&>{})
             : key(std::allocator_arg, alloc, (T &&) t)
             , value(std::allocator_arg, alloc, (U &&) u)
-            , parent_(std::allocator_arg, alloc, nullptr)
             , left_(std::allocator_arg, alloc, nullptr)
             , right_(std::allocator_arg, alloc, nullptr)
-            , color_(std::allocator_arg, alloc, color::red)
+            , parent_color_(std::allocator_arg, alloc, std::uintptr_t(color::red))
         {
         }
+
+        static rb_node_* parent_of(const std::uintptr_t parent_color) noexcept
+        {
+            return (rb_node_*)(parent_color & ~std::uintptr_t(1));
+        }
+
+        static color color_of(const std::uintptr_t parent_color) noexcept
+        {
+            return color(parent_color & 1);
+        }
+
+        rb_node_* parent(const transaction tx) const { return parent_of(parent_color_.get(tx)); }
+        rb_node_* left(const transaction tx) const { return (rb_node_*)left_.get(tx); }
+        rb_node_* right(const transaction tx) const { return (rb_node_*)right_.get(tx); }
+        color     node_color(const transaction tx) const { return color_of(parent_color_.get(tx)); }
+
+        rb_node_* untracked_left(const read_transaction tx) const
+        {
+            return (rb_node_*)left_.untracked_get(tx);
+        }
+        rb_node_* untracked_right(const read_transaction tx) const
+        {
+            return (rb_node_*)right_.untracked_get(tx);
+        }
+
+        void set_parent(const transaction tx, rb_node_* n)
+        {
+            parent_color_.set(tx, std::uintptr_t(n) | std::uintptr_t(node_color(tx)));
+        }
+        void set_left(const transaction tx, rb_node_* n) { left_.set(tx, n); }
+        void set_right(const transaction tx, rb_node_* n) { right_.set(tx, n); }
+        void set_color(const transaction tx, const color c)
+        {
+            parent_color_.set(tx, std::uintptr_t(parent(tx)) | std::uintptr_t(c));
+        }
+
+        void unsafe_set_parent(rb_node_* n) noexcept
+        {
+            parent_color_.unsafe_set(std::uintptr_t(n)
+                                     | std::uintptr_t(color_of(parent_color_.unsafe_get())));
+        }
     };
     struct height_info
     {
@@ -62,6 +103,7 @@ LSTM_BEGIN
         using node_t       = detail::rb_node_<Key, Value, Alloc>;
         using alloc_t      = detail::rebind_to<Alloc, node_t>;
         using alloc_traits = std::allocator_traits<alloc_t>;
+        transaction_domain*                               domain_;
         lstm::var<void*, detail::rebind_to<Alloc, void*>> root_;
 
         template<typename T, typename U>
@@ -84,11 +126,11 @@ LSTM_BEGIN
             if (n == nullptr)
                 return nullptr;
 
-            node_t* parent = (node_t*)n->parent_.get(tx);
+            node_t* parent = n->parent(tx);
             if (parent == nullptr)
                 return nullptr;
 
-            return (node_t*)parent->parent_.get(tx);
+            return parent->parent(tx);
         }
 
         node_t* uncle(const transaction tx, node_t* n)
@@ -97,9 +139,9 @@ LSTM_BEGIN
             if (g == nullptr)
                 return nullptr;
 
-            node_t* left = (node_t*)g->left_.get(tx);
-            if (n->parent_.get(tx) == left)
-                return (node_t*)g->right_.get(tx);
+            node_t* left = g->left(tx);
+            if (n->parent(tx) == left)
+                return g->right(tx);
             else
                 return left;
         }
@@ -109,23 +151,23 @@ LSTM_BEGIN
             if (parent == nullptr)
                 return nullptr;
 
-            const auto p_left = (node_t*)parent->left_.get(tx);
+            const auto p_left = parent->left(tx);
             if (n == p_left)
-                return (node_t*)parent->right_.get(tx);
+                return parent->right(tx);
             return p_left;
         }
 
         void insert_case1(const transaction tx, node_t* n)
         {
-            if (n->parent_.get(tx) == nullptr)
-                n->color_.set(tx, detail::color::black);
+            if (n->parent(tx) == nullptr)
+                n->set_color(tx, detail::color::black);
             else
                 insert_case2(tx, n);
         }
 
         void insert_case2(const transaction tx, node_t* n)
         {
-            if (((node_t*)n->parent_.get(tx))->color_.get(tx) == detail::color::red)
+            if (n->parent(tx)->node_color(tx) == detail::color::red)
                 insert_case3(tx, n);
         }
 
@@ -133,11 +175,11 @@ LSTM_BEGIN
         {
             node_t* u = uncle(tx, n);
 
-            if (u != nullptr && u->color_.get(tx) == detail::color::red) {
-                ((node_t*)n->parent_.get(tx))->color_.set(tx, detail::color::black);
-                u->color_.set(tx, detail::color::black);
+            if (u != nullptr && u->node_color(tx) == detail::color::red) {
+                n->parent(tx)->set_color(tx, detail::color::black);
+                u->set_color(tx, detail::color::black);
                 node_t* g = grandparent(tx, n);
-                g->color_.set(tx, detail::color::red);
+                g->set_color(tx, detail::color::red);
                 insert_case1(tx, g);
             } else {
                 insert_case4(tx, n);
@@ -148,40 +190,38 @@ LSTM_BEGIN
         {
             node_t* g = grandparent(tx, n);
 
-            if (n == ((node_t*)n->parent_.get(tx))->right_.get(tx)
-                && n->parent_.get(tx) == g->left_.get(tx)) {
+            if (n == n->parent(tx)->right(tx) && n->parent(tx) == g->left(tx)) {
                 // rotate_left(n->parent);
 
-                node_t* saved_p      = (node_t*)g->left_.get(tx);
-                node_t* saved_left_n = (node_t*)n->left_.get(tx);
+                node_t* saved_p      = g->left(tx);
+                node_t* saved_left_n = n->left(tx);
 
-                g->left_.set(tx, n);
-                n->parent_.set(tx, g);
+                g->set_left(tx, n);
+                n->set_parent(tx, g);
 
-                n->left_.set(tx, saved_p);
-                saved_p->parent_.set(tx, n);
+                n->set_left(tx, saved_p);
+                saved_p->set_parent(tx, n);
 
-                saved_p->right_.set(tx, saved_left_n);
+                saved_p->set_right(tx, saved_left_n);
                 if (saved_left_n)
-                    saved_left_n->parent_.set(tx, saved_p);
+                    saved_left_n->set_parent(tx, saved_p);
 
                 n = saved_p;
-            } else if (n == ((node_t*)n->parent_.get(tx))->left_.get(tx)
-                       && n->parent_.get(tx) == g->right_.get(tx)) {
+            } else if (n == n->parent(tx)->left(tx) && n->parent(tx) == g->right(tx)) {
                 // rotate_right(n->parent);
 
-                node_t* saved_p       = (node_t*)g->right_.get(tx);
-                node_t* saved_right_n = (node_t*)n->right_.get(tx);
+                node_t* saved_p       = g->right(tx);
+                node_t* saved_right_n = n->right(tx);
 
-                g->right_.set(tx, n);
-                n->parent_.set(tx, g);
+                g->set_right(tx, n);
+                n->set_parent(tx, g);
 
-                n->right_.set(tx, saved_p);
-                saved_p->parent_.set(tx, n);
+                n->set_right(tx, saved_p);
+                saved_p->set_parent(tx, n);
 
-                saved_p->left_.set(tx, saved_right_n);
+                saved_p->set_left(tx, saved_right_n);
                 if (saved_right_n)
-                    saved_right_n->parent_.set(tx, saved_p);
+                    saved_right_n->set_parent(tx, saved_p);
 
                 n = saved_p;
             }
@@ -192,9 +232,9 @@ LSTM_BEGIN
         {
             node_t* g = grandparent(tx, n);
 
-            ((node_t*)n->parent_.get(tx))->color_.set(tx, detail::color::black);
-            g->color_.set(tx, detail::color::red);
-            if (n == ((node_t*)n->parent_.get(tx))->left_.get(tx))
+            n->parent(tx)->set_color(tx, detail::color::black);
+            g->set_color(tx, detail::color::red);
+            if (n == n->parent(tx)->left(tx))
                 rotate_right(tx, g);
             else
                 rotate_left(tx, g);
@@ -202,113 +242,118 @@ LSTM_BEGIN
 
         void rotate_left(const transaction tx, node_t* n)
         {
-            node_t* p        = (node_t*)n->right_.get(tx);
-            node_t* p_left   = (node_t*)p->left_.get(tx);
-            node_t* n_parent = (node_t*)n->parent_.get(tx);
-            bool    left     = n_parent && n_parent->left_.get(tx) == n;
-            n->right_.set(tx, p_left);
+            node_t* p        = n->right(tx);
+            node_t* p_left   = p->left(tx);
+            node_t* n_parent = n->parent(tx);
+            bool    left     = n_parent && n_parent->left(tx) == n;
+            n->set_right(tx, p_left);
 
             if (p_left)
-                p_left->parent_.set(tx, n);
+                p_left->set_parent(tx, n);
 
-            p->left_.set(tx, n);
-            n->parent_.set(tx, p);
+            p->set_left(tx, n);
+            n->set_parent(tx, p);
 
-            p->parent_.set(tx, n_parent);
+            p->set_parent(tx, n_parent);
             if (!n_parent)
                 root_.set(tx, p);
             else if (left)
-                n_parent->left_.set(tx, p);
+                n_parent->set_left(tx, p);
             else
-                n_parent->right_.set(tx, p);
+                n_parent->set_right(tx, p);
         }
 
         void rotate_right(const transaction tx, node_t* n)
         {
-            node_t* p        = (node_t*)n->left_.get(tx);
-            node_t* p_right  = (node_t*)p->right_.get(tx);
-            node_t* n_parent = (node_t*)n->parent_.get(tx);
-            bool    left     = n_parent && n_parent->left_.get(tx) == n;
-            n->left_.set(tx, p_right);
+            node_t* p        = n->left(tx);
+            node_t* p_right  = p->right(tx);
+            node_t* n_parent = n->parent(tx);
+            bool    left     = n_parent && n_parent->left(tx) == n;
+            n->set_left(tx, p_right);
 
             if (p_right)
-                p_right->parent_.set(tx, n);
+                p_right->set_parent(tx, n);
 
-            p->right_.set(tx, n);
-            n->parent_.set(tx, p);
+            p->set_right(tx, n);
+            n->set_parent(tx, p);
 
-            p->parent_.set(tx, n_parent);
+            p->set_parent(tx, n_parent);
             if (!n_parent)
                 root_.set(tx, p);
             else if (left)
-                n_parent->left_.set(tx, p);
+                n_parent->set_left(tx, p);
             else
-                n_parent->right_.set(tx, p);
+                n_parent->set_right(tx, p);
         }
 
         void push_impl(const transaction tx, node_t* new_node)
         {
-            node_t* parent = nullptr;
-            node_t* next_parent;
-
-            auto*       cur = &root_;
-            const auto& key = new_node->key.unsafe_get();
-
-            auto read_tx = tx.unsafe_checked_demote();
-            while ((next_parent = (node_t*)cur->untracked_get(read_tx))) {
-                cur = compare(key, next_parent->key.untracked_get(read_tx)) ? &next_parent->left_
-                                                                            : &next_parent->right_;
-                parent = next_parent;
+            node_t*     parent = nullptr;
+            bool        left   = false;
+            const auto& key    = new_node->key.unsafe_get();
+
+            auto    read_tx     = tx.unsafe_checked_demote();
+            node_t* next_parent = (node_t*)root_.untracked_get(read_tx);
+            while (next_parent) {
+                parent      = next_parent;
+                left        = compare(key, parent->key.untracked_get(read_tx));
+                next_parent = left ? parent->untracked_left(read_tx)
+                                   : parent->untracked_right(read_tx);
             }
             auto root = root_.get(tx);
             if (parent && parent != root) {
                 parent->key.get(tx);
-                parent->left_.get(tx);
-                parent->right_.get(tx);
-                auto pp = (node_t*)parent->parent_.get(tx);
+                parent->left(tx);
+                parent->right(tx);
+                auto pp = parent->parent(tx);
                 if (pp && pp != root) {
-                    pp->left_.get(tx);
-                    pp->right_.get(tx);
+                    pp->left(tx);
+                    pp->right(tx);
                 }
             }
 
-            new_node->parent_.unsafe_set(parent);
-            cur->set(tx, new_node);
+            new_node->unsafe_set_parent(parent);
+            if (!parent)
+                root_.set(tx, new_node);
+            else if (left)
+                parent->set_left(tx, new_node);
+            else
+                parent->set_right(tx, new_node);
             insert_case1(tx, new_node);
         }
 
         void replace_node(const transaction tx, node_t* n, node_t* child)
         {
-            auto parent = (node_t*)n->parent_.get(tx);
+            auto parent = n->parent(tx);
             if (parent) {
-                if (parent->left_.get(tx) == n)
-                    parent->left_.set(tx, child);
+                if (parent->left(tx) == n)
+                    parent->set_left(tx, child);
                 else
-                    parent->right_.set(tx, child);
+                    parent->set_right(tx, child);
             } else {
                 root_.set(tx, child);
             }
             if (child)
-                child->parent_.set(tx, parent);
+                child->set_parent(tx, parent);
         }
 
         static detail::color color(const transaction tx, node_t* n)
         {
-            return n ? n->color_.get(tx) : detail::color::black;
+            return n ? n->node_color(tx) : detail::color::black;
         }
 
         void delete_case6(const transaction tx, node_t* parent, node_t* n)
         {
             auto s = sibling(tx, parent, n);
 
-            s->color_.set(tx, parent->color_.get(tx));
-            parent->color_.set(tx, detail::color::black);
+            s->set_color(tx, parent->node_color(tx));
+            parent->set_color(tx, detail::color::black);
 
-            if (n == parent->left_.get(tx)) {
-                ((node_t*)s->right_.get(tx))->color_.set(tx, detail::color::black);
+            if (n == parent->left(tx)) {
+                s->right(tx)->set_color(tx, detail::color::black);
                 rotate_left(tx, parent);
             } else {
-                ((node_t*)s->left_.get(tx))->color_.set(tx, detail::color::black);
+                s->left(tx)->set_color(tx, detail::color::black);
                 rotate_right(tx, parent);
             }
         }
@@ -317,25 +362,25 @@ LSTM_BEGIN
         {
             auto s = sibling(tx, parent, n);
 
-            if (s->color_.get(tx) == detail::color::black) { /* this if statement is trivial,
+            if (s->node_color(tx) == detail::color::black) { /* this if statement is trivial,
           due to case 2 (even though case 2 changed the sibling to a sibling's child,
           the sibling's child can't be red, since no red parent can have a red child). */
                 /* the following statements just force the red to be on the left of the left of the
                    parent,
                    or right of the right, so case six will rotate correctly. */
-                auto s_left  = (node_t*)s->left_.get(tx);
-                auto s_right = (node_t*)s->right_.get(tx);
-                if (n == parent->left_.get(tx) && color(tx, s_right) == detail::color::black
+                auto s_left  = s->left(tx);
+                auto s_right = s->right(tx);
+                if (n == parent->left(tx) && color(tx, s_right) == detail::color::black
                     && (color(tx, s_left) == detail::color::red)) {
                     // this last test is trivial too due to cases 2-4.
-                    s->color_.set(tx, detail::color::red);
-                    s_left->color_.set(tx, detail::color::black);
+                    s->set_color(tx, detail::color::red);
+                    s_left->set_color(tx, detail::color::black);
                     rotate_right(tx, s);
-                } else if (n == parent->right_.get(tx) && color(tx, s_left) == detail::color::black
+                } else if (n == parent->right(tx) && color(tx, s_left) == detail::color::black
                            && color(tx, s_right) == detail::color::red) {
                     // this last test is trivial too due to cases 2-4.
-                    s->color_.set(tx, detail::color::red);
-                    s_right->color_.set(tx, detail::color::black);
+                    s->set_color(tx, detail::color::red);
+                    s_right->set_color(tx, detail::color::black);
                     rotate_left(tx, s);
                 }
             }
@@ -346,12 +391,12 @@ LSTM_BEGIN
         {
             node_t* s = sibling(tx, parent, n);
 
-            if (parent->color_.get(tx) == detail::color::red
-                && s->color_.get(tx) == detail::color::black
-                && color(tx, (node_t*)s->left_.get(tx)) == detail::color::black
-                && color(tx, (node_t*)s->right_.get(tx)) == detail::color::black) {
-                s->color_.set(tx, detail::color::red);
-                parent->color_.set(tx, detail::color::black);
+            if (parent->node_color(tx) == detail::color::red
+                && s->node_color(tx) == detail::color::black
+                && color(tx, s->left(tx)) == detail::color::black
+                && color(tx, s->right(tx)) == detail::color::black) {
+                s->set_color(tx, detail::color::red);
+                parent->set_color(tx, detail::color::black);
             } else {
                 delete_case5(tx, parent, n);
             }
@@ -361,12 +406,12 @@ LSTM_BEGIN
         {
             node_t* s = sibling(tx, parent, n);
 
-            if (parent->color_.get(tx) == detail::color::black
+            if (parent->node_color(tx) == detail::color::black
                 && color(tx, s) == detail::color::black
-                && (!s || color(tx, (node_t*)s->left_.get(tx)) == detail::color::black)
-                && (!s || color(tx, (node_t*)s->right_.get(tx)) == detail::color::black)) {
-                s->color_.set(tx, detail::color::red);
-                delete_case1(tx, (node_t*)parent->parent_.get(tx), parent);
+                && (!s || color(tx, s->left(tx)) == detail::color::black)
+                && (!s || color(tx, s->right(tx)) == detail::color::black)) {
+                s->set_color(tx, detail::color::red);
+                delete_case1(tx, parent->parent(tx), parent);
             } else {
                 delete_case4(tx, parent, n);
             }
@@ -376,9 +421,9 @@ LSTM_BEGIN
         {
             auto s = sibling(tx, parent, n);
             if (color(tx, s) == detail::color::red) {
-                parent->color_.set(tx, detail::color::red);
-                s->color_.set(tx, detail::color::black);
-                if (n == parent->left_.get(tx))
+                parent->set_color(tx, detail::color::red);
+                s->set_color(tx, detail::color::black);
+                if (n == parent->left(tx))
                     rotate_left(tx, parent);
                 else
                     rotate_right(tx, parent);
@@ -394,23 +439,23 @@ LSTM_BEGIN
 
         void delete_one_child(const transaction tx, node_t* n)
         {
-            node_t* right = (node_t*)n->right_.get(tx);
-            node_t* child = !right ? (node_t*)n->left_.get(tx) : right;
+            node_t* right = n->right(tx);
+            node_t* child = !right ? n->left(tx) : right;
 
             replace_node(tx, n, child);
-            if (n->color_.get(tx) == detail::color::black) {
+            if (n->node_color(tx) == detail::color::black) {
                 if (color(tx, child) == detail::color::red)
-                    child->color_.set(tx, detail::color::black);
+                    child->set_color(tx, detail::color::black);
                 else
-                    delete_case1(tx, (node_t*)n->parent_.get(tx), child);
+                    delete_case1(tx, n->parent(tx), child);
             }
             lstm::destroy_deallocate(tx, alloc(), n);
         }
 
         void erase_impl(const transaction tx, node_t* to_erase)
         {
-            if (to_erase->left_.get(tx) && to_erase->right_.get(tx)) {
-                node_t* temp = min_node(tx, (node_t*)to_erase->right_.get(tx));
+            if (to_erase->left(tx) && to_erase->right(tx)) {
+                node_t* temp = min_node(tx, to_erase->right(tx));
 
                 to_erase->key.set(tx, temp->key.get(tx));
                 to_erase->value.set(tx, temp->value.get(tx));
@@ -424,7 +469,7 @@ LSTM_BEGIN
         {
             node_t* next;
             /* loop down to find the leftmost leaf */
-            while ((next = (node_t*)current->left_.get(tx)))
+            while ((next = current->left(tx)))
                 current = next;
 
             return current;
@@ -436,27 +481,27 @@ LSTM_BEGIN
             if (!node)
                 return {0, 0, 0};
 
-            auto left     = (node_t*)node->left_.get(tx);
-            auto right    = (node_t*)node->right_.get(tx);
+            auto left     = node->left(tx);
+            auto right    = node->right(tx);
             auto height_l = minmax_height(tx, left);
             auto height_r = minmax_height(tx, right);
 
             LSTM_ASSERT(height_l.black_height == height_r.black_height);
 
-            LSTM_ASSERT(!left || left->parent_.get(tx) == node);
-            LSTM_ASSERT(!right || right->parent_.get(tx) == node);
+            LSTM_ASSERT(!left || left->parent(tx) == node);
+            LSTM_ASSERT(!right || right->parent(tx) == node);
 
             LSTM_ASSERT(!left || !compare(node->key.get(tx), left->key.get(tx)));
             LSTM_ASSERT(!right || !compare(right->key.get(tx), node->key.get(tx)));
 
-            if (node->color_.get(tx) == detail::color::red) {
-                LSTM_ASSERT(!left || left->color_.get(tx) == detail::color::black);
-                LSTM_ASSERT(!right || right->color_.get(tx) == detail::color::black);
+            if (node->node_color(tx) == detail::color::red) {
+                LSTM_ASSERT(!left || left->node_color(tx) == detail::color::black);
+                LSTM_ASSERT(!right || right->node_color(tx) == detail::color::black);
             }
 
             return {std::min(height_l.min_height, height_r.min_height) + 1,
                     std::max(height_l.max_height, height_r.max_height) + 1,
-                    height_l.black_height + (node->color_.get(tx) == detail::color::black ? 1 : 0)};
+                    height_l.black_height + (node->node_color(tx) == detail::color::black ? 1 : 0)};
         }
 #endif
 
@@ -480,7 +525,14 @@ LSTM_BEGIN
 
     public:
         rbtree(const Alloc& alloc = {}) noexcept
+            : rbtree(default_domain(), alloc)
+        {
+        }
+
+        // all transactions passed to the tree must be running in `domain`
+        explicit rbtree(transaction_domain& domain, const Alloc& alloc = {}) noexcept
             : alloc_t(alloc)
+            , domain_(&domain)
             , root_{std::allocator_arg, alloc, nullptr}
         {
         }
@@ -494,8 +546,11 @@ LSTM_BEGIN
                 destroy_deallocate_subtree(alloc(), root);
         }
 
+        transaction_domain& domain() const noexcept { return *domain_; }
+
         void clear(const transaction tx)
         {
+            LSTM_ASSERT(&tx.domain() == domain_);
             if (auto root = (node_t*)root_.get(tx)) {
                 root_.set(tx, nullptr);
                 tx.sometime_synchronized_after([ alloc = this->alloc(), root ]() noexcept {
@@ -510,9 +565,9 @@ LSTM_BEGIN
             while (cur) {
                 const auto& key = cur->key.untracked_get(tx);
                 if (compare(u, key))
-                    cur = (node_t*)cur->left_.untracked_get(tx);
+                    cur = cur->untracked_left(tx);
                 else if (compare(key, u))
-                    cur = (node_t*)cur->right_.untracked_get(tx);
+                    cur = cur->untracked_right(tx);
                 else
                     break;
             }
@@ -522,11 +577,13 @@ LSTM_BEGIN
         template<typename... Us, LSTM_REQUIRES_(std::is_constructible<node_t, alloc_t&, Us&&...>{})>
         void emplace(const transaction tx, Us&&... us)
         {
+            LSTM_ASSERT(&tx.domain() == domain_);
             push_impl(tx, lstm::allocate_construct(tx, alloc(), alloc(), (Us &&) us...));
         }
 
         bool erase_one(const transaction tx, const Key& key)
         {
+            LSTM_ASSERT(&tx.domain() == domain_);
             if (auto to_erase = find(tx.unsafe_checked_demote(), key)) {
                 erase_impl(tx, to_erase);
                 return true;
@@ -539,7 +596,7 @@ LSTM_BEGIN
         {
             auto root = (node_t*)root_.get(tx);
             if (root)
-                LSTM_ASSERT(root->color_.get(tx) == detail::color::black);
+                LSTM_ASSERT(root->node_color(tx) == detail::color::black);
             const detail::height_info heights = minmax_height(tx, root);
             (void)heights;
             LSTM_ASSERT(heights.min_height * 2 >= heights.max_height);
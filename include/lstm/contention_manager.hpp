@@ -0,0 +1,324 @@
+#ifndef LSTM_CONTENTION_MANAGER_HPP
+#define LSTM_CONTENTION_MANAGER_HPP
+
+#include <lstm/detail/backoff.hpp>
+
+#include <chrono>
+#include <exception>
+
+// contention manager policies, chosen per transaction_domain, or per call to lstm::atomic through
+// lstm::with_contention_manager. each policy is a set of static functions over a contention_info:
+//  - backoff: called after an attempt at a transaction fails, and before it is retried
+//  - lock_spins: called by a committing transaction that finds a var it writes locked. returns how
+//    many more times the var is checked before the commit gives up
+LSTM_BEGIN
+    struct contention_info
+    {
+        // failed attempts so far, and why the last one failed. var is the var the last attempt
+        // failed on, if known. var::caused tells whether it is a given var
+        std::size_t             retries;
+        abort_reason            reason;
+        abort_cause             cause;
+        const detail::var_base* var;
+        // the read and write set sizes of the last failed attempt. lock_spins sees the sizes of
+        // the attempt that is committing
+        std::size_t reads;
+        std::size_t writes;
+        // reads and writes summed over every failed attempt
+        std::size_t work;
+        // the versions the first failed attempt, and the latest attempt started at. the difference
+        // is how many commits the transaction has been running for
+        epoch_t first_version;
+        epoch_t version;
+    };
+
+    // yields after every failure, and never waits on locked vars. the default
+    struct yield_manager
+    {
+        static void backoff(const contention_info&) noexcept { detail::yield{}(); }
+
+        static std::size_t lock_spins(const contention_info&) noexcept { return 0; }
+    };
+
+    // waits on locked vars for a bounded number of spins, and otherwise behaves as yield_manager
+    template<std::size_t Spins = 64>
+    struct spin_manager
+    {
+        static void backoff(const contention_info& info) noexcept { yield_manager::backoff(info); }
+
+        static std::size_t lock_spins(const contention_info&) noexcept { return Spins; }
+    };
+
+    // sleeps exponentially longer after each failure, and waits on locked vars a little
+    template<typename Interval = std::chrono::microseconds,
+             std::size_t Min   = 1,
+             std::size_t Max   = 1024,
+             std::size_t Spins = 16>
+    struct polite_manager
+    {
+        static void backoff(const contention_info& info) noexcept
+        {
+            detail::exponential_delay<Interval, Min, Max>::delay_after(info.retries);
+        }
+
+        static std::size_t lock_spins(const contention_info&) noexcept { return Spins; }
+    };
+
+    // priority is karma: the reads and writes a transaction has made, summed over its attempts.
+    // transactions with more karma wait on locked vars for longer, and back off for less time
+    template<typename Interval = std::chrono::microseconds,
+             std::size_t Max      = 1024,
+             std::size_t MaxSpins = 1024>
+    struct karma_manager
+    {
+        static void backoff(const contention_info& info) noexcept
+        {
+            const std::size_t delay = Max / (info.work + 1);
+            if (delay == 0) {
+                detail::yield{}();
+            } else {
+                LSTM_PERF_STATS_BACKOFFS();
+                LSTM_THIS_CONTEXT::sleep_for(Interval(delay));
+            }
+        }
+
+        static std::size_t lock_spins(const contention_info& info) noexcept
+        {
+            const std::size_t karma = info.work + info.reads + info.writes;
+            return karma < MaxSpins ? karma : MaxSpins;
+        }
+    };
+
+    // priority is age: the commits since the first failed attempt of a transaction, which keeps its
+    // timestamp across retries. older transactions wait on locked vars for longer, and younger
+    // ones back off exponentially
+    template<typename Interval = std::chrono::microseconds,
+             std::size_t Min      = 1,
+             std::size_t Max      = 1024,
+             std::size_t MaxSpins = 1024>
+    struct greedy_manager
+    {
+        static std::size_t age(const contention_info& info) noexcept
+        {
+            return info.version - info.first_version;
+        }
+
+        static void backoff(const contention_info& info) noexcept
+        {
+            const std::size_t a = age(info);
+            if (a >= info.retries)
+                detail::yield{}();
+            else
+                detail::exponential_delay<Interval, Min, Max>::delay_after(info.retries - a);
+        }
+
+        static std::size_t lock_spins(const contention_info& info) noexcept
+        {
+            const std::size_t a = age(info);
+            return a < MaxSpins ? a : MaxSpins;
+        }
+    };
+
+    // read write transactions that have failed Retries times become irrevocable, and otherwise
+    // behave as under ContentionManager. an irrevocable transaction holds a token that makes every
+    // other commit in its domain fail, and waits out locked vars instead of retrying, so it never
+    // fails on a conflict. only one transaction per domain is irrevocable at a time. with
+    // LSTM_NOREC defined, transactions never become irrevocable
+    template<std::size_t Retries, typename ContentionManager = yield_manager>
+    struct irrevocable_after : ContentionManager
+    {
+        static bool irrevocable(const contention_info& info) noexcept
+        {
+            return info.retries >= Retries;
+        }
+    };
+
+    // thrown out of lstm::atomic when a transaction run under with_attempt_limit or with_deadline
+    // fails with its budget spent. the transaction has been rolled back, and info describes its
+    // failures
+    struct budget_exhausted : std::exception
+    {
+        contention_info info;
+
+        explicit budget_exhausted(const contention_info& in_info) noexcept
+            : info(in_info)
+        {
+        }
+
+        const char* what() const noexcept override { return "lstm: transaction budget exhausted"; }
+    };
+LSTM_END
+
+LSTM_DETAIL_BEGIN
+    template<typename T>
+    using contention_backoff_ = decltype(T::backoff(std::declval<const contention_info&>()));
+
+    template<typename T>
+    using contention_lock_spins_
+        = decltype(std::size_t{T::lock_spins(std::declval<const contention_info&>())});
+
+    template<typename T>
+    using is_contention_manager
+        = and_<supports<contention_backoff_, T>, supports<contention_lock_spins_, T>>;
+
+    template<typename T>
+    using contention_irrevocable_
+        = decltype(bool{T::irrevocable(std::declval<const contention_info&>())});
+
+    inline bool never_irrevocable(const contention_info&) noexcept { return false; }
+
+    template<typename ContentionManager,
+             LSTM_REQUIRES_(supports<contention_irrevocable_, ContentionManager>{})>
+    constexpr auto contention_irrevocable_fn() noexcept
+    {
+        return &ContentionManager::irrevocable;
+    }
+
+    template<typename ContentionManager,
+             LSTM_REQUIRES_(!supports<contention_irrevocable_, ContentionManager>{})>
+    constexpr auto contention_irrevocable_fn() noexcept
+    {
+        return &never_irrevocable;
+    }
+
+    template<typename ContentionManager, typename Func>
+    struct contention_managed
+    {
+        Func func;
+
+        template<typename... Args>
+        auto operator()(Args&&... args) noexcept(noexcept(std::declval<Func&>()((Args &&) args...)))
+            -> decltype(std::declval<Func&>()((Args &&) args...))
+        {
+            return func((Args &&) args...);
+        }
+    };
+
+    template<typename Func>
+    struct contention_manager_of
+    {
+        using type = void;
+    };
+
+    template<typename ContentionManager, typename Func>
+    struct contention_manager_of<contention_managed<ContentionManager, Func>>
+    {
+        using type = ContentionManager;
+    };
+
+    struct attempt_budget
+    {
+        std::size_t max_attempts;
+
+        bool exhausted(const contention_info& info) const noexcept
+        {
+            return info.retries >= max_attempts;
+        }
+    };
+
+    template<typename Clock, typename Duration>
+    struct deadline_budget
+    {
+        std::chrono::time_point<Clock, Duration> deadline;
+
+        bool exhausted(const contention_info&) const noexcept { return Clock::now() >= deadline; }
+    };
+
+    template<typename Budget, typename Func>
+    struct budgeted
+    {
+        Budget budget;
+        Func   func;
+
+        template<typename... Args>
+        auto operator()(Args&&... args) noexcept(noexcept(std::declval<Func&>()((Args &&) args...)))
+            -> decltype(std::declval<Func&>()((Args &&) args...))
+        {
+            return func((Args &&) args...);
+        }
+    };
+
+    template<typename Budget, typename Func>
+    struct contention_manager_of<budgeted<Budget, Func>> : contention_manager_of<Func>
+    {
+    };
+
+    template<typename Func>
+    struct is_budgeted : std::false_type
+    {
+    };
+
+    template<typename Budget, typename Func>
+    struct is_budgeted<budgeted<Budget, Func>> : std::true_type
+    {
+    };
+
+    template<typename ContentionManager, typename Func>
+    struct is_budgeted<contention_managed<ContentionManager, Func>> : is_budgeted<Func>
+    {
+    };
+
+    template<typename Func>
+    bool out_of_budget(const Func&, const contention_info&) noexcept
+    {
+        return false;
+    }
+
+    template<typename Budget, typename Func>
+    bool out_of_budget(const budgeted<Budget, Func>& func, const contention_info& info) noexcept
+    {
+        return func.budget.exhausted(info) || out_of_budget(func.func, info);
+    }
+
+    template<typename ContentionManager, typename Func>
+    bool out_of_budget(const contention_managed<ContentionManager, Func>& func,
+                       const contention_info&                             info) noexcept
+    {
+        return out_of_budget(func.func, info);
+    }
+LSTM_DETAIL_END
+
+LSTM_BEGIN
+    // runs func under ContentionManager, instead of the contention manager of the domain
+    template<typename ContentionManager,
+             typename Func,
+             LSTM_REQUIRES_(detail::is_contention_manager<ContentionManager>{})>
+    detail::contention_managed<ContentionManager, std::decay_t<Func>>
+    with_contention_manager(Func&& func)
+    {
+        return {(Func &&) func};
+    }
+
+    // runs func irrevocably from its first attempt, for transactions too large to ever commit
+    // under contention. as with with_contention_manager, a nested transaction merges into the
+    // rootmost transaction, and is only irrevocable if that transaction is
+    template<typename Func>
+    detail::contention_managed<irrevocable_after<0>, std::decay_t<Func>> irrevocable(Func&& func)
+    {
+        return {(Func &&) func};
+    }
+
+#if LSTM_HAS_EXCEPTIONS
+    // runs func at most max_attempts times, throwing budget_exhausted after the last attempt fails.
+    // budgets only apply to the rootmost transaction, and compose with with_contention_manager
+    template<typename Func>
+    detail::budgeted<detail::attempt_budget, std::decay_t<Func>>
+    with_attempt_limit(const std::size_t max_attempts, Func&& func)
+    {
+        LSTM_ASSERT(max_attempts > 0);
+        return {{max_attempts}, (Func &&) func};
+    }
+
+    // retries func until deadline, throwing budget_exhausted once an attempt fails at or past it.
+    // an attempt in progress is never interrupted, and lstm::retry backs off instead of blocking
+    // until a var it read is written
+    template<typename Clock, typename Duration, typename Func>
+    detail::budgeted<detail::deadline_budget<Clock, Duration>, std::decay_t<Func>>
+    with_deadline(const std::chrono::time_point<Clock, Duration> deadline, Func&& func)
+    {
+        return {{deadline}, (Func &&) func};
+    }
+#endif /* LSTM_HAS_EXCEPTIONS */
+LSTM_END
+
+#endif /* LSTM_CONTENTION_MANAGER_HPP */
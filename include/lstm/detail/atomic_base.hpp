@@ -1,7 +1,11 @@
 #ifndef LSTM_DETAIL_ATOMIC_BASE_HPP
 #define LSTM_DETAIL_ATOMIC_BASE_HPP
 
-#include <lstm/detail/transaction_domain.hpp>
+#include <lstm/detail/commit_algorithm.hpp>
+#include <lstm/detail/restart.hpp>
+#include <lstm/detail/retry_waiters.hpp>
+
+#include <lstm/transaction_domain.hpp>
 
 #include <lstm/thread_data.hpp>
 
@@ -29,11 +33,68 @@ LSTM_DETAIL_BEGIN
         static void set_rw(thread_data& tls_td) noexcept { tls_td.tx_state = tx_kind::read_write; }
         static void set_read(thread_data& tls_td) noexcept { tls_td.tx_state = tx_kind::read_only; }
 
+        // value based validation has nothing but the read set to validate, so with LSTM_NOREC
+        // defined, snapshot isolated transactions track their reads like any read write transaction
+        static void set_snapshot_isolated(thread_data& tls_td) noexcept
+        {
+            LSTM_ASSERT(!tls_td.in_transaction());
+#ifndef LSTM_NOREC
+            tls_td.tx_snapshot_isolated = true;
+#else
+            (void)tls_td;
+#endif
+        }
+
+        // asked of the contention manager before every attempt at a read write transaction. the
+        // token is taken outside of a critical section, as its holder may be waiting to reclaim
+        static void irrevocable_start(thread_data& tls_td, transaction_domain& domain) noexcept
+        {
+#ifndef LSTM_NOREC
+            const contention_policy* policy = tls_td.tx_contention_policy;
+            if (LSTM_LIKELY(!policy) || !policy->irrevocable(tls_td.tx_contention))
+                return;
+
+            thread_data* owner = nullptr;
+            while (!domain.irrevocable_owner.compare_exchange_weak(owner,
+                                                                   &tls_td,
+                                                                   LSTM_SEQ_CST,
+                                                                   LSTM_RELAXED)) {
+                // already never blocked, and the token will not be given up before this returns
+                if (owner && owner == tls_td.open_nested_parent)
+                    return;
+                owner = nullptr;
+                yield{}();
+            }
+            // pairs with the check committers make after locking their writes. a commit either
+            // sees the token, or has its writes locked before any var is read
+            std::atomic_thread_fence(LSTM_SEQ_CST);
+            tls_td.tx_irrevocable = true;
+#else
+            (void)tls_td;
+            (void)domain;
+#endif
+        }
+
+        static void irrevocable_end(thread_data& tls_td) noexcept
+        {
+            if (LSTM_UNLIKELY(tls_td.tx_irrevocable)) {
+                tls_td.domain().irrevocable_owner.store(nullptr, LSTM_RELEASE);
+                tls_td.tx_irrevocable = false;
+            }
+        }
+
         template<tx_kind kind>
         static void tx_failure_no_backoff(thread_data& tls_td) noexcept
         {
             static_assert(kind != tx_kind::none);
 
+            if (kind != tx_kind::read_only) {
+                commit_algorithm::rollback(tls_td);
+                irrevocable_end(tls_td);
+            }
+
+            // lazy clocks rely on failed transactions to move the clock forward
+            tls_td.domain().advance_past(tls_td.version());
             tls_td.access_unlock();
 
             LSTM_PERF_STATS_FAILURES();
@@ -44,6 +105,7 @@ LSTM_DETAIL_BEGIN
 
             if (kind != tx_kind::read_only) {
                 tls_td.clear_read_write_sets();
+                tls_td.commit_callbacks.clear();
                 tls_td.succ_callbacks.clear_working_epoch();
                 tls_td.do_fail_callbacks();
             } else {
@@ -54,11 +116,88 @@ LSTM_DETAIL_BEGIN
             }
         }
 
+        template<typename ContentionManager>
+        static const contention_policy* contention_policy_of(const transaction_domain&,
+                                                             ContentionManager*) noexcept
+        {
+            return contention_policy_for<ContentionManager>();
+        }
+
+        static const contention_policy* contention_policy_of(const transaction_domain& domain,
+                                                             void*) noexcept
+        {
+            return domain.contention;
+        }
+
+        // functions wrapped by with_contention_manager override the contention manager of the
+        // domain
+        template<typename Func>
+        static void contention_start(thread_data& tls_td, const transaction_domain& domain) noexcept
+        {
+            using contention_manager = typename contention_manager_of<uncvref<Func>>::type;
+            tls_td.tx_contention_policy
+                = contention_policy_of(domain, static_cast<contention_manager*>(nullptr));
+            tls_td.tx_contention = {};
+        }
+
         template<tx_kind kind>
-        static void tx_failure(thread_data& tls_td) noexcept
+        [[noreturn]] static void budget_failure(thread_data& tls_td)
+        {
+            tx_failure_no_backoff<kind>(tls_td);
+
+            tls_td.tx_state             = tx_kind::none;
+            tls_td.tx_snapshot_isolated = false;
+
+#if LSTM_HAS_EXCEPTIONS
+            throw ::lstm::budget_exhausted{tls_td.tx_contention};
+#else
+            std::terminate();
+#endif
+        }
+
+        template<tx_kind kind, typename Func>
+        static void tx_failure(thread_data& tls_td, const abort_reason reason, const Func& func)
         {
+            // read write transactions record the cause of internal failures where they happen. read
+            // transactions have no thread_data to record it in, and only fail on reads
+            if (reason == abort_reason::retry)
+                tls_td.set_abort_cause(abort_cause::retry, nullptr);
+            else if (kind == tx_kind::read_only)
+                tls_td.set_abort_cause(abort_cause::read_conflict, nullptr);
+            LSTM_PERF_STATS_ABORT_CAUSE(tls_td.tx_contention.cause);
+
+            contention_info& info = tls_td.tx_contention;
+            if (info.retries++ == 0)
+                info.first_version = tls_td.epoch();
+            info.reason  = reason;
+            info.reads   = tls_td.read_set.size();
+            info.writes  = tls_td.write_set.size();
+            info.version = tls_td.epoch();
+            info.work += info.reads + info.writes;
+
+            if (is_budgeted<Func>{} && LSTM_UNLIKELY(out_of_budget(func, info)))
+                budget_failure<kind>(tls_td);
+
+            // lstm::retry blocks until another commit writes to a var the transaction read. open
+            // nested transactions back off instead, as the transaction they are nested in would
+            // hold up reclamation for as long as they block. so do budgeted transactions, as the
+            // wait has no bound
+            if (kind != tx_kind::read_only && reason == abort_reason::retry && !is_budgeted<Func>{}
+                && LSTM_LIKELY(!tls_td.open_nested_parent)) {
+                retry_waiter waiter;
+                if (retry_waiters::prepare(tls_td, waiter)) {
+                    tx_failure_no_backoff<kind>(tls_td);
+                    retry_waiters::wait(waiter);
+                    return;
+                }
+            }
+
             tx_failure_no_backoff<kind>(tls_td);
-            default_backoff{}();
+
+            if (LSTM_LIKELY(!tls_td.tx_contention_policy))
+                yield_manager::backoff(info);
+            else
+                tls_td.tx_contention_policy->backoff(info);
         }
 
         template<tx_kind         kind>
@@ -66,9 +205,14 @@ LSTM_DETAIL_BEGIN
         {
             tx_failure_no_backoff<kind>(tls_td);
 
-            tls_td.tx_state = tx_kind::none;
+            tls_td.tx_state             = tx_kind::none;
+            tls_td.tx_snapshot_isolated = false;
 
+#if LSTM_HAS_EXCEPTIONS
             throw;
+#else
+            std::terminate();
+#endif
         }
 
         template<tx_kind kind>
@@ -76,8 +220,12 @@ LSTM_DETAIL_BEGIN
         {
             static_assert(kind != tx_kind::none);
 
+            // before reclaiming, which may wait on threads waiting for the token
+            if (kind != tx_kind::read_only)
+                irrevocable_end(tls_td);
             tls_td.access_unlock();
-            tls_td.tx_state = tx_kind::none;
+            tls_td.tx_state             = tx_kind::none;
+            tls_td.tx_snapshot_isolated = false;
 
             LSTM_PERF_STATS_SUCCESSES();
             LSTM_PERF_STATS_READS(tls_td.read_set.size());
@@ -88,6 +236,8 @@ LSTM_DETAIL_BEGIN
             if (kind != tx_kind::read_only) {
                 tls_td.clear_read_write_sets();
                 tls_td.fail_callbacks.clear();
+                if (!tls_td.commit_callbacks.empty())
+                    tls_td.do_commit_callbacks();
                 tls_td.reclaim(sync_epoch);
             } else {
                 LSTM_ASSERT(tls_td.succ_callbacks.working_epoch_empty());
@@ -100,7 +250,9 @@ LSTM_DETAIL_BEGIN
         static bool valid_start_state(thread_data& tls_td) noexcept
         {
             return tls_td.read_set.empty() && tls_td.write_set.empty()
-                   && tls_td.fail_callbacks.empty() && tls_td.succ_callbacks.working_epoch_empty();
+                   && tls_td.deferred_log.empty() && tls_td.fail_callbacks.empty()
+                   && tls_td.commit_callbacks.empty()
+                   && tls_td.succ_callbacks.working_epoch_empty();
         }
     };
 LSTM_DETAIL_END
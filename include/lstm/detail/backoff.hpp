@@ -54,6 +54,16 @@ LSTM_DETAIL_BEGIN
         }
 
         void reset() noexcept { interval = Min; }
+
+        // the delay operator() would have reached after `attempts` calls, without keeping state
+        static void delay_after(const std::size_t attempts) noexcept
+        {
+            LSTM_PERF_STATS_BACKOFFS();
+            std::size_t result = Min;
+            for (std::size_t i = 1; i < attempts && result < Max; ++i)
+                result <<= 1;
+            LSTM_THIS_CONTEXT::sleep_for(Interval(result < Max ? result : Max));
+        }
     };
 
     struct yield
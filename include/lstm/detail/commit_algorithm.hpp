@@ -1,7 +1,10 @@
 #ifndef LSTM_DETAIL_COMMIT_ALGORITHM_HPP
 #define LSTM_DETAIL_COMMIT_ALGORITHM_HPP
 
-#include <lstm/detail/transaction_domain.hpp>
+#include <lstm/detail/backoff.hpp>
+#include <lstm/detail/retry_waiters.hpp>
+
+#include <lstm/transaction_domain.hpp>
 
 #include <lstm/transaction.hpp>
 
@@ -9,28 +12,98 @@ LSTM_DETAIL_BEGIN
     namespace
     {
         static constexpr epoch_t commit_failed = off_state;
+        // never a valid sync epoch
+        static constexpr epoch_t commit_pending = off_state;
     }
 
+    // how much a transaction had logged at some point. reads are never rolled back, as what the
+    // transaction read before a savepoint is restored is what it went on to act upon
+    struct savepoint
+    {
+        uword write_set_size;
+        uword savepoint_log_size;
+        uword fail_callbacks_size;
+        uword commit_callbacks_size;
+        uword succ_callbacks_size;
+    };
+
     struct commit_algorithm
     {
     private:
-        using write_set_t         = typename thread_data::write_set_t;
-        using write_set_iter      = typename thread_data::write_set_iter;
-        using read_set_const_iter = typename thread_data::read_set_const_iter;
+        using write_set_t          = typename thread_data::write_set_t;
+        using write_set_iter       = typename thread_data::write_set_iter;
+        using write_set_const_iter = typename write_set_t::const_iterator;
+        using read_set_const_iter  = typename thread_data::read_set_const_iter;
+        using deferred_log_t       = typename thread_data::deferred_log_t;
+        using deferred_iter        = typename thread_data::deferred_iter;
+
+        // locking a var is a full barrier, so the cache misses of a plain loop over the write set
+        // are taken one at a time. the loops over the write set prefetch the var this many entries
+        // ahead instead. the loads that validate the read set are independent, and already overlap
+        static constexpr std::ptrdiff_t prefetch_distance = 16;
+
+        // commits hold their locks only briefly, so rather than failing on a locked var with a
+        // deferred update, the commit reloads its version this many times. the wait is bounded, as
+        // the holder may itself be waiting on a var this commit has locked
+        static constexpr std::size_t deferred_lock_spins = 1024;
 
         commit_algorithm()                        = delete;
         commit_algorithm(const commit_algorithm&) = delete;
         commit_algorithm& operator=(const commit_algorithm&) = delete;
         ~commit_algorithm()                                  = delete;
 
+#ifndef LSTM_NOREC
+        // gives the transaction holding v's lock as many spins to release it as the contention
+        // manager allows
+        LSTM_NOINLINE static epoch_t
+        wait_unlocked(const var_base& v, epoch_t version, const transaction tx) noexcept
+        {
+            const thread_data& tls_td = tx.get_thread_data();
+            if (LSTM_LIKELY(!tls_td.tx_contention_policy))
+                return version;
+
+            contention_info info = tls_td.tx_contention;
+            info.reads           = tls_td.read_set.size();
+            info.writes          = tls_td.write_set.size();
+            info.version         = tls_td.epoch();
+            for (std::size_t spins = tls_td.tx_contention_policy->lock_spins(info);
+                 spins && locked(version);
+                 --spins)
+                version = v.version_lock.load(LSTM_RELAXED);
+            return version;
+        }
+
+        // irrevocable transactions lock whatever holds the var first
+        LSTM_NOINLINE static bool irrevocable_lock(var_base& v, const transaction tx) noexcept
+        {
+            if (!tx.get_thread_data().tx_irrevocable)
+                return false;
+
+            epoch_t version_buf = v.version_lock.load(LSTM_RELAXED);
+            while (locked(version_buf)
+                   || !v.version_lock.compare_exchange_weak(version_buf,
+                                                            as_locked(version_buf),
+                                                            LSTM_SEQ_CST,
+                                                            LSTM_RELAXED)) {
+                yield{}();
+                version_buf = v.version_lock.load(LSTM_RELAXED);
+            }
+            return true;
+        }
+
+        // sequentially consistent, so that the irrevocable check in slower_path is ordered after
+        // every lock
         static inline bool lock(var_base& v, const transaction tx) noexcept
         {
             epoch_t version_buf = v.version_lock.load(LSTM_RELAXED);
-            return tx.read_write_valid(version_buf)
-                   && v.version_lock.compare_exchange_strong(version_buf,
-                                                             as_locked(version_buf),
-                                                             LSTM_ACQUIRE,
-                                                             LSTM_RELAXED);
+            if (LSTM_UNLIKELY(locked(version_buf)))
+                version_buf = wait_unlocked(v, version_buf, tx);
+            return (tx.read_write_valid(version_buf)
+                    && v.version_lock.compare_exchange_strong(version_buf,
+                                                              as_locked(version_buf),
+                                                              LSTM_SEQ_CST,
+                                                              LSTM_RELAXED))
+                   || LSTM_UNLIKELY(irrevocable_lock(v, tx));
         }
 
         // x86_64: likely compiles to mov
@@ -55,6 +128,20 @@ LSTM_DETAIL_BEGIN
                 unlock(begin->dest_var());
         }
 
+        LSTM_NOINLINE static void
+        unlock_deferred(deferred_iter begin, const deferred_iter end) noexcept
+        {
+            for (; begin != end; ++begin)
+                unlock_as_version(begin->dest_var(), begin->version());
+        }
+
+        static void unlock_writes(thread_data& tls_td) noexcept
+        {
+            unlock_write_set(tls_td.write_set.begin(), tls_td.write_set.end());
+            if (LSTM_UNLIKELY(!tls_td.deferred_log.empty()))
+                unlock_deferred(tls_td.deferred_log.begin(), tls_td.deferred_log.end());
+        }
+
         static void remove_writes_from_reads(thread_data& tls_td) noexcept
         {
             const read_set_const_iter begin = tls_td.read_set.begin();
@@ -72,8 +159,11 @@ LSTM_DETAIL_BEGIN
             const write_set_iter write_end   = tls_td.write_set.end();
 
             for (write_set_iter write_iter = write_begin; write_iter != write_end; ++write_iter) {
+                if (write_end - write_iter > prefetch_distance)
+                    LSTM_PREFETCH_WRITE(&write_iter[prefetch_distance].dest_var());
                 if (LSTM_UNLIKELY(!lock(write_iter->dest_var(), tx))) {
                     unlock_write_set(write_begin, write_iter);
+                    tls_td.set_abort_cause(abort_cause::lock_conflict, &write_iter->dest_var());
                     return false;
                 }
             }
@@ -81,68 +171,483 @@ LSTM_DETAIL_BEGIN
             return true;
         }
 
+        // vars with deferred updates are locked whatever their version, as the updates apply to
+        // whatever the vars hold by then
+        LSTM_NOINLINE static bool lock_deferred(const transaction tx) noexcept
+        {
+            thread_data&        tls_td = tx.get_thread_data();
+            const deferred_iter begin  = tls_td.deferred_log.begin();
+            const deferred_iter end    = tls_td.deferred_log.end();
+
+            for (deferred_iter iter = begin; iter != end; ++iter) {
+                var_base& v       = iter->dest_var();
+                epoch_t   version = v.version_lock.load(LSTM_RELAXED);
+                do {
+                    for (std::size_t spins = deferred_lock_spins; spins && locked(version); --spins)
+                        version = v.version_lock.load(LSTM_RELAXED);
+                    if (LSTM_UNLIKELY(locked(version))) {
+                        version = wait_unlocked(v, version, tx);
+                        if (locked(version)) {
+                            unlock_write_set(tls_td.write_set.begin(), tls_td.write_set.end());
+                            unlock_deferred(begin, iter);
+                            tls_td.set_abort_cause(abort_cause::lock_conflict, &v);
+                            return false;
+                        }
+                    }
+                } while (!v.version_lock.compare_exchange_weak(version,
+                                                               as_locked(version),
+                                                               LSTM_SEQ_CST,
+                                                               LSTM_RELAXED));
+                iter->set_version(version);
+            }
+            return true;
+        }
+
+        // a var that was read, and then given a deferred update, is locked by the commit itself.
+        // the read is valid if the version the var was locked at is
+        LSTM_NOINLINE static bool deferred_read_valid(const transaction tx,
+                                                      const var_base&   src_var) noexcept
+        {
+            thread_data&        tls_td = tx.get_thread_data();
+            const deferred_iter iter   = tls_td.find_deferred(src_var);
+            return iter != tls_td.deferred_log.end() && tx.read_write_valid(iter->version());
+        }
+
+        // vars owned under encounter time locking were valid when they were locked. on failure,
+        // rollback restores them
         static bool validate_reads(const transaction tx) noexcept
         {
             thread_data& tls_td = tx.get_thread_data();
             for (const read_set_value_type read_set_value : tls_td.read_set) {
-                if (LSTM_UNLIKELY(!tx.read_write_valid(read_set_value.src_var()))) {
-                    unlock_write_set(tls_td.write_set.begin(), tls_td.write_set.end());
+                const epoch_t version = read_set_value.src_var().version_lock.load(LSTM_RELAXED);
+                if (LSTM_UNLIKELY(!tx.read_write_valid(version) && version != tls_td.tx_owner_lock
+                                  && !deferred_read_valid(tx, read_set_value.src_var()))) {
+                    unlock_writes(tls_td);
+                    tls_td.set_abort_cause(abort_cause::validation, &read_set_value.src_var());
                     return false;
                 }
             }
             return true;
         }
 
-        static void do_writes(const write_set_t& write_set) noexcept
+#else
+        // value based validation: every var in the read set still holds the storage that was read
+        // from it. the read set also holds the storage each write replaces
+        static bool validate_reads(const thread_data& tls_td) noexcept
+        {
+            for (const read_set_value_type read_set_value : tls_td.read_set) {
+                if (LSTM_UNLIKELY(read_set_value.src_var().storage.load(LSTM_ACQUIRE).ptr
+                                  != read_set_value.observed().ptr))
+                    return false;
+            }
+            return true;
+        }
+#endif
+
+        // whether the var of read is in any of the logs of tls_td. compares addresses only
+        static bool writes_to(const thread_data& tls_td, const read_set_value_type read) noexcept
+        {
+            if (tls_td.write_set.find(read.src_var()) != tls_td.write_set.end())
+                return true;
+            for (const undo_log_value_type undo_log_value : tls_td.undo_log) {
+                if (read.is_src_var(undo_log_value.dest_var()))
+                    return true;
+            }
+            for (const deferred_value_type deferred_value : tls_td.deferred_log) {
+                if (read.is_src_var(deferred_value.dest_var()))
+                    return true;
+            }
+            return false;
+        }
+
+        // marks the threads blocked in lstm::retry on a var tls_td writes, for the commit of waker
+        // to wake. done before publishing where the logs do not outlive it, as the undo log is
+        // cleared by publish_undo_log, and the write set of a combined commit by its owning thread
+        LSTM_NOINLINE static bool woken_by(transaction_domain& domain,
+                                           const thread_data&  tls_td,
+                                           const hash_t        retry_waits,
+                                           const void* const   waker) noexcept
+        {
+            hash_t writes = 0;
+            for (const write_set_value_type write_set_value : tls_td.write_set)
+                writes |= reference_hash(write_set_value.dest_var());
+            for (const undo_log_value_type undo_log_value : tls_td.undo_log)
+                writes |= reference_hash(undo_log_value.dest_var());
+            for (const deferred_value_type deferred_value : tls_td.deferred_log)
+                writes |= reference_hash(deferred_value.dest_var());
+            if (!(writes & retry_waits))
+                return false;
+            return retry_waiters::mark(domain,
+                                       writes,
+                                       [&](const read_set_value_type read) {
+                                           return writes_to(tls_td, read);
+                                       },
+                                       waker);
+        }
+
+        LSTM_NOINLINE static void do_deferred(const deferred_log_t& deferred_log) noexcept
+        {
+            for (const deferred_value_type deferred_value : deferred_log) {
+                var_base& v = deferred_value.dest_var();
+                v.storage.store(deferred_value.apply(v.storage.load(LSTM_RELAXED)), LSTM_RELEASE);
+            }
+        }
+
+        static void do_writes(const thread_data& tls_td) noexcept
+        {
+            const write_set_t&         write_set = tls_td.write_set;
+            const write_set_const_iter end       = write_set.end();
+            for (write_set_const_iter iter = write_set.begin(); iter != end; ++iter) {
+                if (end - iter > prefetch_distance)
+                    LSTM_PREFETCH_WRITE(&iter[prefetch_distance].dest_var());
+                iter->dest_var().storage.store(iter->pending_write(), LSTM_RELEASE);
+            }
+            if (LSTM_UNLIKELY(!tls_td.deferred_log.empty()))
+                do_deferred(tls_td.deferred_log);
+        }
+
+        // a deferred update whose var was written afterwards is part of that write already
+        LSTM_NOINLINE static void drop_written_deferred(thread_data& tls_td) noexcept
+        {
+            const deferred_iter begin = tls_td.deferred_log.begin();
+            for (deferred_iter iter = tls_td.deferred_log.end(); iter != begin;) {
+                --iter;
+                if (tls_td.write_set.find(iter->dest_var()) != tls_td.write_set.end())
+                    tls_td.deferred_log.unordered_erase(iter);
+            }
+        }
+
+#ifndef LSTM_NOREC
+        static void publish(const thread_data& tls_td, const epoch_t write_version) noexcept
+        {
+            const write_set_t&         write_set = tls_td.write_set;
+            const write_set_const_iter end       = write_set.end();
+            for (write_set_const_iter iter = write_set.begin(); iter != end; ++iter) {
+                if (end - iter > prefetch_distance)
+                    LSTM_PREFETCH_WRITE(&iter[prefetch_distance].dest_var());
+                unlock_as_version(iter->dest_var(), write_version);
+            }
+            for (const deferred_value_type deferred_value : tls_td.deferred_log)
+                unlock_as_version(deferred_value.dest_var(), write_version);
+        }
+
+        static void publish_undo_log(thread_data& tls_td, const epoch_t write_version) noexcept
+        {
+            for (const undo_log_value_type undo_log_value : tls_td.undo_log)
+                unlock_as_version(undo_log_value.dest_var(), write_version);
+            tls_td.undo_log.clear();
+        }
+
+        // publishes every commit posted to the domain at a single write version. each posted
+        // transaction has already locked its writes, and validated its reads
+        static void combine(transaction_domain& domain) noexcept
         {
-            for (write_set_value_type write_set_value : write_set)
-                write_set_value.dest_var().storage.store(write_set_value.pending_write(),
-                                                         LSTM_RELEASE);
+            thread_data* const requests = domain.commit_requests.exchange(nullptr, LSTM_ACQUIRE);
+            if (!requests)
+                return;
+
+            const hash_t retry_waits    = domain.retry_waits.load(LSTM_SEQ_CST);
+            bool         woken          = false;
+            bool         ordered_commit = false;
+            for (thread_data* td = requests; td; td = td->next_commit_request) {
+                do_writes(*td);
+                ordered_commit |= td->tx_ordered_commit;
+            }
+
+            const epoch_t sync_epoch = LSTM_UNLIKELY(ordered_commit)
+                                           ? domain.fetch_and_bump_clock_ordered()
+                                           : domain.fetch_and_bump_clock();
+
+            for (thread_data* td = requests; td;) {
+                LSTM_ASSERT(td->tx_irrevocable || td->tx_version <= sync_epoch);
+                if (LSTM_UNLIKELY(retry_waits))
+                    woken |= woken_by(domain, *td, retry_waits, requests);
+                publish(*td, sync_epoch + transaction_domain::bump_size());
+                if (!td->undo_log.empty())
+                    publish_undo_log(*td, sync_epoch + transaction_domain::bump_size());
+
+                // td finishes its transaction as soon as it sees the result
+                thread_data* const next = td->next_commit_request;
+                td->commit_result.store(sync_epoch, LSTM_RELEASE);
+                td = next;
+            }
+
+            if (LSTM_UNLIKELY(woken))
+                retry_waiters::wake(domain, requests);
         }
 
-        static void publish(const write_set_t& write_set, const epoch_t write_version) noexcept
+        // posts the transaction to the domain, and waits for a combiner to publish it. if no other
+        // thread is combining, this thread becomes the combiner
+        static epoch_t combining_commit(thread_data& tls_td) noexcept
         {
-            for (write_set_value_type write_set_value : write_set)
-                unlock_as_version(write_set_value.dest_var(), write_version);
+            transaction_domain& domain = tls_td.domain();
+
+            tls_td.commit_result.store(commit_pending, LSTM_RELAXED);
+            thread_data* head = domain.commit_requests.load(LSTM_RELAXED);
+            do {
+                tls_td.next_commit_request = head;
+            } while (!domain.commit_requests.compare_exchange_weak(head,
+                                                                   &tls_td,
+                                                                   LSTM_RELEASE,
+                                                                   LSTM_RELAXED));
+
+            default_backoff backoff;
+            while (true) {
+                const epoch_t sync_epoch = tls_td.commit_result.load(LSTM_ACQUIRE);
+                if (sync_epoch != commit_pending)
+                    return sync_epoch;
+
+                if (!domain.combining.load(LSTM_RELAXED)
+                    && !domain.combining.exchange(true, LSTM_ACQUIRE)) {
+                    combine(domain);
+                    domain.combining.store(false, LSTM_RELEASE);
+                } else {
+                    backoff();
+                }
+            }
+        }
+
+        // fails the commit if another transaction is irrevocable. the writes are already locked, so
+        // the irrevocable transaction waits on them rather than reading around them. open nested
+        // transactions commit under the token of the transaction they are nested in
+        static bool blocked_by_irrevocable(thread_data& tls_td) noexcept
+        {
+            const thread_data* const owner = tls_td.domain().irrevocable_owner.load(LSTM_SEQ_CST);
+            if (LSTM_LIKELY(!owner) || owner == tls_td.open_nested_parent)
+                return false;
+            unlock_writes(tls_td);
+            tls_td.set_abort_cause(abort_cause::irrevocable, nullptr);
+            return true;
         }
 
         static epoch_t slower_path(const transaction tx) noexcept
         {
-            // last check
-            if (!validate_reads(tx))
+            thread_data& tls_td = tx.get_thread_data();
+
+            // last check. nothing else commits while a transaction is irrevocable
+            if (LSTM_LIKELY(!tls_td.tx_irrevocable)
+                && (!validate_reads(tx) || blocked_by_irrevocable(tls_td)))
                 return commit_failed;
 
-            const write_set_t& write_set = tx.get_thread_data().write_set;
+            if (LSTM_UNLIKELY(tls_td.domain().get_commit_mode() == commit_mode::combining))
+                return combining_commit(tls_td);
+
+            // the writes are locked, so threads blocking in lstm::retry after this load see them
+            const hash_t retry_waits = tls_td.domain().retry_waits.load(LSTM_SEQ_CST);
+            const bool   woken       = LSTM_UNLIKELY(retry_waits)
+                                       && woken_by(tls_td.domain(), tls_td, retry_waits, &tls_td);
 
-            do_writes(write_set);
+            do_writes(tls_td);
 
-            const epoch_t sync_epoch = default_domain().fetch_and_bump_clock();
-            LSTM_ASSERT(tx.version() <= sync_epoch);
+            const epoch_t sync_epoch = LSTM_UNLIKELY(tls_td.tx_ordered_commit)
+                                           ? tls_td.domain().fetch_and_bump_clock_ordered()
+                                           : tls_td.domain().fetch_and_bump_clock();
+            LSTM_ASSERT(tls_td.tx_irrevocable || tx.version() <= sync_epoch);
 
-            publish(write_set, sync_epoch + transaction_domain::bump_size());
+            publish(tls_td, sync_epoch + transaction_domain::bump_size());
+            if (!tls_td.undo_log.empty())
+                publish_undo_log(tls_td, sync_epoch + transaction_domain::bump_size());
+
+            if (LSTM_UNLIKELY(woken))
+                retry_waiters::wake(tls_td.domain(), &tls_td);
 
             return sync_epoch;
         }
 
         static epoch_t slow_path(const transaction tx) noexcept
         {
-            remove_writes_from_reads(tx.get_thread_data());
-            if (!lock_writes(tx))
+            thread_data& tls_td = tx.get_thread_data();
+            remove_writes_from_reads(tls_td);
+            if (!lock_writes(tx)
+                || (LSTM_UNLIKELY(!tls_td.deferred_log.empty()) && !lock_deferred(tx)))
                 return commit_failed;
             return slower_path(tx);
         }
+#else
+        // a single CAS takes the domain's sequence lock, if nothing has committed since the version
+        // of the transaction. otherwise, the reads are validated again at the newer version first,
+        // which is not possible after reads that are never revalidated
+        static epoch_t slow_path(const transaction tx) noexcept
+        {
+            thread_data&        tls_td     = tx.get_thread_data();
+            transaction_domain& domain     = tls_td.domain();
+            epoch_t             sync_epoch = tx.version();
+
+            while (!domain.try_lock_sequence(sync_epoch)) {
+                sync_epoch = domain.get_clock();
+                if (tls_td.tx_unvalidated_reads || !validate_reads(tls_td)) {
+                    tls_td.set_abort_cause(abort_cause::validation, nullptr);
+                    return commit_failed;
+                }
+            }
+
+            // the sequence lock is held, so threads blocking in lstm::retry after this load see the
+            // commit. they are only looked up once it is released, as every transaction that starts
+            // meanwhile spins on it, and nothing here clears the write set
+            const hash_t retry_waits = domain.retry_waits.load(LSTM_SEQ_CST);
+
+            do_writes(tls_td);
+            domain.unlock_sequence(sync_epoch);
+
+            if (LSTM_UNLIKELY(retry_waits) && woken_by(domain, tls_td, retry_waits, &tls_td))
+                retry_waiters::wake(domain, &tls_td);
+
+            return sync_epoch;
+        }
+#endif
 
     public:
         static epoch_t try_commit(const transaction tx) noexcept
         {
-            LSTM_ASSERT(tx.version() <= default_domain().get_clock());
+            thread_data& tls_td = tx.get_thread_data();
+            LSTM_ASSERT(tls_td.tx_irrevocable || tx.version() <= tls_td.domain().get_clock());
 
-            const thread_data& tls_td = tx.get_thread_data();
-            if (tls_td.write_set.empty())
-                return std::numeric_limits<epoch_t>::lowest(); // synchronize on the earliest epoch
+            if (LSTM_UNLIKELY(!tls_td.deferred_log.empty()))
+                drop_written_deferred(tls_td);
+
+            if (tls_td.write_set.empty() && LSTM_LIKELY(tls_td.deferred_log.empty())) {
+                // synchronize on the earliest epoch
+                if (LSTM_LIKELY(tls_td.undo_log.empty()))
+                    return std::numeric_limits<epoch_t>::lowest();
+#ifndef LSTM_NOREC
+                // under encounter time locking, every write is already locked and in place
+                return slower_path(tx);
+#endif
+            }
 
             return slow_path(tx);
         }
+
+        // restores the vars written by a failed transaction under encounter time locking. other
+        // transactions may have loaded the discarded storage, so the vars are published at a fresh
+        // version instead of the version they had before
+        static void rollback(thread_data& tls_td) noexcept
+        {
+            if (LSTM_LIKELY(tls_td.undo_log.empty()))
+                return;
+
+#ifndef LSTM_NOREC
+
+            for (const undo_log_value_type undo_log_value : tls_td.undo_log)
+                undo_log_value.dest_var().storage.store(undo_log_value.prev_storage(),
+                                                        LSTM_RELAXED);
+
+            const epoch_t sync_epoch = LSTM_UNLIKELY(tls_td.tx_ordered_commit)
+                                           ? tls_td.domain().fetch_and_bump_clock_ordered()
+                                           : tls_td.domain().fetch_and_bump_clock();
+            publish_undo_log(tls_td, sync_epoch + transaction_domain::bump_size());
+#endif
+        }
+
+        static savepoint take_savepoint(thread_data& tls_td) noexcept
+        {
+            // the outermost savepoint drops what earlier savepoints logged
+            if (!tls_td.tx_savepoints++)
+                tls_td.savepoint_log.clear();
+            return {tls_td.write_set.size(),
+                    tls_td.savepoint_log.size(),
+                    tls_td.fail_callbacks.size(),
+                    tls_td.commit_callbacks.size(),
+                    tls_td.succ_callbacks.working_epoch_size()};
+        }
+
+        // ends the savepoint, which may still be restored afterwards. the storage logged since it
+        // was taken is kept, in case an enclosing savepoint is restored
+        static void release_savepoint(thread_data& tls_td) noexcept
+        {
+            LSTM_ASSERT(tls_td.tx_savepoints);
+            --tls_td.tx_savepoints;
+        }
+
+        // discards the writes made since sp was taken. no var is locked while a savepoint is
+        // active, so the storage those writes replaced is only visible to this transaction
+        static void restore_savepoint(thread_data& tls_td, const savepoint& sp) noexcept
+        {
+            LSTM_ASSERT(tls_td.savepoint_log.size() >= sp.savepoint_log_size);
+
+            for (uword i = tls_td.savepoint_log.size(); i-- != sp.savepoint_log_size;) {
+                const undo_log_value_type undo_log_value = tls_td.savepoint_log.begin()[i];
+                var_base&                 dest_var       = undo_log_value.dest_var();
+                const write_set_lookup    lookup         = tls_td.write_set.lookup(dest_var);
+                if (lookup.success())
+                    lookup.pending_write() = undo_log_value.prev_storage();
+                else
+                    dest_var.storage.store(undo_log_value.prev_storage(), LSTM_RELAXED);
+            }
+            tls_td.savepoint_log.truncate(sp.savepoint_log_size);
+            tls_td.write_set.truncate(sp.write_set_size);
+            // reads of vars with deferred updates must still find them
+            for (const deferred_value_type deferred_value : tls_td.deferred_log)
+                tls_td.write_set.reset_filter(tls_td.write_set.filter()
+                                              | reference_hash(deferred_value.dest_var()));
+            tls_td.do_fail_callbacks(sp.fail_callbacks_size);
+            tls_td.commit_callbacks.truncate(sp.commit_callbacks_size);
+            tls_td.succ_callbacks.truncate_working_epoch(sp.succ_callbacks_size);
+        }
+
+        // single var commits validate nothing but the version the storage of the var was loaded
+        // at. that is the version of the var itself, or the sequence lock under LSTM_NOREC
+        static epoch_t single_var_version(const transaction_domain& domain,
+                                          const var_base&           v) noexcept
+        {
+#ifndef LSTM_NOREC
+            (void)domain;
+            return v.version_lock.load(LSTM_ACQUIRE);
+#else
+            (void)v;
+            return domain.load_sequence_lock();
+#endif
+        }
+
+        // whether the storage of v loaded since version was current all along
+        static bool single_var_valid(const transaction_domain& domain,
+                                     const var_base&           v,
+                                     const epoch_t             version) noexcept
+        {
+            return !locked(version) && single_var_version(domain, v) == version;
+        }
+
+        // publishes new_storage to v, locking nothing else, if nothing has written v since version.
+        // fails without writing if something has, or if another transaction is irrevocable.
+        // only multi_version_var writes need an ordered commit, and single var updates take an
+        // lstm::var, so the clock is bumped unordered
+        static bool try_single_var_commit(transaction_domain& domain,
+                                          var_base&           v,
+                                          const var_storage   new_storage,
+                                          epoch_t             version) noexcept
+        {
+            if (locked(version))
+                return false;
+#ifndef LSTM_NOREC
+            if (!v.version_lock.compare_exchange_strong(version,
+                                                        as_locked(version),
+                                                        LSTM_SEQ_CST,
+                                                        LSTM_RELAXED))
+                return false;
+            if (LSTM_UNLIKELY(domain.irrevocable_owner.load(LSTM_SEQ_CST))) {
+                unlock(v);
+                return false;
+            }
+#else
+            if (!domain.try_lock_sequence(version))
+                return false;
+#endif
+
+            // v is locked, so threads blocking in lstm::retry after this load see the write
+            const bool woken = domain.retry_waits.load(LSTM_SEQ_CST) & reference_hash(v);
+
+            v.storage.store(new_storage, LSTM_RELEASE);
+#ifndef LSTM_NOREC
+            const epoch_t sync_epoch = domain.fetch_and_bump_clock();
+            unlock_as_version(v, sync_epoch + transaction_domain::bump_size());
+#else
+            domain.unlock_sequence(version);
+#endif
+
+            if (LSTM_UNLIKELY(woken))
+                retry_waiters::wake(domain, v);
+            return true;
+        }
     };
 LSTM_DETAIL_END
 
@@ -321,6 +321,34 @@
 #  endif
 /******************** end pure ********************/
 
+/******************** prefetch ********************/
+#  if LSTM_COMPILER_IS_Clang || LSTM_COMPILER_IS_GNU || LSTM_COMPILER_IS_AppleClang
+#    define LSTM_PREFETCH(ptr) __builtin_prefetch((ptr), 0)
+#    define LSTM_PREFETCH_WRITE(ptr) __builtin_prefetch((ptr), 1)
+#  elif LSTM_COMPILER_IS_MSVC && (defined(_M_X64) || defined(_M_IX86))
+#    include <xmmintrin.h>
+#    define LSTM_PREFETCH(ptr) _mm_prefetch(reinterpret_cast<const char*>(ptr), _MM_HINT_T0)
+#    define LSTM_PREFETCH_WRITE(ptr) _mm_prefetch(reinterpret_cast<const char*>(ptr), _MM_HINT_T0)
+#  else
+#    define LSTM_PREFETCH(ptr) ((void)(ptr))
+#    define LSTM_PREFETCH_WRITE(ptr) ((void)(ptr))
+#  endif
+/****************** end prefetch ******************/
+
+/******************* exceptions *******************/
+// LSTM_NO_EXCEPTIONS makes aborts restart transactions with longjmp instead of throwing, and is
+// implied when exceptions are disabled. an abort is then tens of times cheaper, but
+// lstm::with_attempt_limit and lstm::with_deadline are unavailable
+#  if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#    define LSTM_HAS_EXCEPTIONS 1
+#  else
+#    define LSTM_HAS_EXCEPTIONS 0
+#    ifndef LSTM_NO_EXCEPTIONS
+#      define LSTM_NO_EXCEPTIONS
+#    endif
+#  endif
+/***************** end exceptions *****************/
+
 /******************** TSX/TLE *********************/
 #  ifndef LSTM_NO_HTM
 #    if defined(__GNUC__) && defined(__x86_64__)
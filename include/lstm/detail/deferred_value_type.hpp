@@ -0,0 +1,99 @@
+#ifndef LSTM_DETAIL_DEFERRED_VALUE_TYPE_HPP
+#define LSTM_DETAIL_DEFERRED_VALUE_TYPE_HPP
+
+#include <lstm/detail/lstm_fwd.hpp>
+
+#include <functional>
+
+LSTM_DETAIL_BEGIN
+    // computes the storage of an atomic var after a commutative update by operand
+    using deferred_fn = var_storage (*)(var_storage, var_storage);
+
+    struct deferred_min
+    {
+        template<typename T>
+        T operator()(const T& lhs, const T& rhs) const noexcept
+        {
+            return rhs < lhs ? rhs : lhs;
+        }
+    };
+
+    struct deferred_max
+    {
+        template<typename T>
+        T operator()(const T& lhs, const T& rhs) const noexcept
+        {
+            return lhs < rhs ? rhs : lhs;
+        }
+    };
+
+    using deferred_add = std::plus<>;
+    using deferred_or  = std::bit_or<>;
+
+    // storage is zeroed first, as atomic vars do, so that equal values compare equal under value
+    // based validation
+    template<typename T, typename Op>
+    var_storage deferred_apply(const var_storage storage, const var_storage operand) noexcept
+    {
+        var_storage result{};
+        ::new (result.raw) T(Op{}(*reinterpret_cast<const T*>(storage.raw),
+                                  *reinterpret_cast<const T*>(operand.raw)));
+        return result;
+    }
+
+    // deferred updates are associative and commutative, so a later update to the same var by the
+    // same operation folds into the operand
+    struct deferred_value_type
+    {
+    private:
+        var_base*   dest_var_;
+        var_storage operand_;
+        deferred_fn apply_;
+        // the version dest_var held when the commit locked it
+        epoch_t     version_;
+
+        inline deferred_value_type() noexcept = default;
+
+    public:
+        inline deferred_value_type(var_base* const   in_dest_var,
+                                   const var_storage in_operand,
+                                   const deferred_fn in_apply) noexcept
+            : dest_var_(in_dest_var)
+            , operand_(in_operand)
+            , apply_(in_apply)
+            , version_(0)
+        {
+            LSTM_ASSERT(dest_var_);
+            LSTM_ASSERT(apply_);
+        }
+
+        inline var_base& dest_var() const noexcept
+        {
+            LSTM_ASSERT(dest_var_);
+            return *dest_var_;
+        }
+
+        inline bool is_dest_var(const var_base& rhs) const noexcept
+        {
+            LSTM_ASSERT(dest_var_);
+            return dest_var_ == &rhs;
+        }
+
+        inline bool applies(const deferred_fn apply) const noexcept { return apply_ == apply; }
+
+        inline var_storage apply(const var_storage storage) const noexcept
+        {
+            return apply_(storage, operand_);
+        }
+
+        inline void combine(const var_storage later_operand) noexcept
+        {
+            operand_ = apply_(operand_, later_operand);
+        }
+
+        inline epoch_t version() const noexcept { return version_; }
+        inline void    set_version(const epoch_t version) noexcept { version_ = version; }
+    };
+LSTM_DETAIL_END
+
+#endif /* LSTM_DETAIL_DEFERRED_VALUE_TYPE_HPP */
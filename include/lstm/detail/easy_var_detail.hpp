@@ -7,8 +7,9 @@
     template<typename U, LSTM_REQUIRES_(concept<U>{})>                                             \
     derived& operator symbol##=(const U u)                                                         \
     {                                                                                              \
-        lstm::read_write(                                                                          \
-            [&](const transaction tx) { underlying().set(tx, underlying().get(tx) symbol u); });   \
+        lstm::atomic_update(easy_var_domain(),                                                     \
+                            underlying(),                                                          \
+                            [&](const T& value) { return value symbol u; });                       \
         return static_cast<derived&>(*this);                                                       \
     }                                                                                              \
     template<typename U, typename UAlloc, LSTM_REQUIRES_(concept<U>{})>                            \
@@ -24,18 +25,16 @@
 #define LSTM_RMW_UNARY_OP(symbol)                                                                  \
     derived& operator symbol##symbol()                                                             \
     {                                                                                              \
-        lstm::read_write([&](const transaction tx) {                                               \
-            underlying().set(tx, underlying().get(tx) symbol T(1));                                \
-        });                                                                                        \
+        lstm::atomic_update(easy_var_domain(),                                                     \
+                            underlying(),                                                          \
+                            [](const T& value) { return value symbol T(1); });                     \
         return static_cast<derived&>(*this);                                                       \
     }                                                                                              \
     T operator symbol##symbol(int)                                                                 \
     {                                                                                              \
-        return lstm::read_write([&](const transaction tx) {                                        \
-            auto result = underlying().get(tx);                                                    \
-            underlying().set(tx, result symbol T(1));                                              \
-            return result;                                                                         \
-        });                                                                                        \
+        return lstm::atomic_update(easy_var_domain(),                                              \
+                                   underlying(),                                                   \
+                                   [](const T& value) { return value symbol T(1); });              \
     }                                                                                              \
 /**/
 
@@ -45,6 +44,13 @@ LSTM_BEGIN
 LSTM_END
 
 LSTM_DETAIL_BEGIN
+    // the domain of easy_var's single var updates, matching that of its domainless transactions
+    inline transaction_domain& easy_var_domain() noexcept
+    {
+        thread_data& tls_td = tls_thread_data();
+        return tls_td.in_transaction() ? tls_td.domain() : default_domain();
+    }
+
     template<typename T,
              typename Alloc,
              bool = std::is_arithmetic<T>{},
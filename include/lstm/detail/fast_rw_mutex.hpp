@@ -81,7 +81,7 @@ LSTM_DETAIL_BEGIN
         }
 
     public:
-        fast_rw_mutex() noexcept
+        constexpr fast_rw_mutex() noexcept
             : read_count{0}
         {
         }
@@ -80,6 +80,9 @@ LSTM_BEGIN
     template<typename T, typename Alloc = std::allocator<std::remove_reference_t<T>>>
     struct var;
 
+    template<typename T, typename Alloc = std::allocator<std::remove_reference_t<T>>>
+    struct multi_version_var;
+
     struct transaction;
     struct read_transaction;
     struct transaction_domain;
@@ -87,6 +90,44 @@ LSTM_BEGIN
 
     template<typename T>
     struct privatized_future;
+
+    template<std::size_t Size>
+    struct hand_over_hand;
+
+    // why an attempt at a transaction failed
+    //  - conflict: a var was newer than the transaction, and the snapshot could not be extended
+    //  - commit: the write set could not be locked, or the read set failed validation at commit
+    //  - retry: lstm::retry() was called
+    enum class abort_reason : char
+    {
+        none = 0,
+        conflict,
+        commit,
+        retry,
+    };
+
+    // where an attempt at a transaction failed, in more detail than its abort_reason
+    //  - read_conflict: a var being read was locked or too new (conflict)
+    //  - write_conflict: a var being written was locked or too new (conflict)
+    //  - lock_conflict: the commit could not lock a var it writes (commit)
+    //  - validation: a var in the read set changed before the commit validated it (commit)
+    //  - irrevocable: another transaction in the domain was irrevocable (commit)
+    //  - retry: lstm::retry() was called (retry)
+    enum class abort_cause : char
+    {
+        none = 0,
+        read_conflict,
+        write_conflict,
+        lock_conflict,
+        validation,
+        irrevocable,
+        retry,
+    };
+
+#ifdef LSTM_PERF_STATS_ON
+    static_assert(static_cast<std::size_t>(abort_cause::retry) + 1 == detail::abort_cause_count,
+                  "perf_stats needs a count for every abort_cause");
+#endif
 LSTM_END
 
 LSTM_DETAIL_BEGIN
@@ -100,8 +141,13 @@ LSTM_DETAIL_BEGIN
 
     struct commit_algorithm;
     struct var_base;
+    struct version_node_base;
     struct transaction_base;
     struct atomic_base_fn;
+    struct retry_waiter;
+    struct retry_waiters;
+    struct single_var_fn;
+    struct domain_retirement;
 
     template<std::size_t Padding>
     struct thread_synchronization_node;
@@ -111,6 +157,7 @@ LSTM_DETAIL_BEGIN
 
     struct tx_retry
     {
+        abort_reason reason;
     };
 
     template<typename T>
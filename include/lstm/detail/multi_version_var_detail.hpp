@@ -0,0 +1,135 @@
+#ifndef LSTM_DETAIL_MULTI_VERSION_VAR_DETAIL_HPP
+#define LSTM_DETAIL_MULTI_VERSION_VAR_DETAIL_HPP
+
+#include <lstm/detail/var_detail.hpp>
+
+LSTM_DETAIL_BEGIN
+    // each committed value of a multi_version_var lives in a node, which points at the node it
+    // replaced, and the version that node was committed at. replaced nodes are reclaimed after a
+    // grace period, so the chain is only ever as long as the oldest running transaction needs
+    struct version_node_base
+    {
+        version_node_base* prev;
+        epoch_t            prev_version;
+    };
+
+    template<typename T>
+    struct version_node : version_node_base
+    {
+        T value;
+
+        template<typename... Us>
+        explicit version_node(Us&&... us) noexcept(std::is_nothrow_constructible<T, Us&&...>{})
+            : version_node_base{nullptr, 0}
+            , value((Us &&) us...)
+        {
+        }
+    };
+
+    template<typename T, typename Alloc>
+    struct multi_version_var_policy
+        : private alloc_wrapper<
+              typename std::allocator_traits<Alloc>::template rebind_alloc<version_node<T>>>,
+          var_base
+    {
+    protected:
+        using node_alloc_type =
+            typename std::allocator_traits<Alloc>::template rebind_alloc<version_node<T>>;
+        using alloc_traits = std::allocator_traits<node_alloc_type>;
+        using alloc_wrapper<node_alloc_type>::alloc;
+
+        explicit multi_version_var_policy() noexcept(
+            noexcept(allocate_construct())
+            && std::is_nothrow_default_constructible<node_alloc_type>{})
+            : var_base(allocate_construct())
+        {
+        }
+
+        template<typename U,
+                 typename... Us,
+                 LSTM_REQUIRES_(!std::is_same<uncvref<U>, std::allocator_arg_t>{}
+                                && !std::is_same<uncvref<U>, multi_version_var_policy>{})>
+        explicit multi_version_var_policy(U&& u, Us&&... us) noexcept(
+            noexcept(allocate_construct((U &&) u, (Us &&) us...))
+            && std::is_nothrow_default_constructible<node_alloc_type>{})
+            : var_base(allocate_construct((U &&) u, (Us &&) us...))
+        {
+        }
+
+        template<typename... Us>
+        explicit multi_version_var_policy(std::allocator_arg_t, const Alloc& in_alloc, Us&&... us)
+            noexcept(noexcept(allocate_construct((Us &&) us...)))
+            : alloc_wrapper<node_alloc_type>(node_alloc_type(in_alloc))
+            , var_base(allocate_construct((Us &&) us...))
+        {
+        }
+
+        ~multi_version_var_policy() noexcept
+        {
+            multi_version_var_policy::destroy_deallocate(alloc(), storage.load(LSTM_RELAXED));
+        }
+
+        template<typename... Us>
+        var_storage allocate_construct(Us&&... us) noexcept(
+            noexcept(alloc_traits::allocate(alloc(), 1))
+            && noexcept(alloc_traits::construct(alloc(),
+                                                (version_node<T>*)nullptr,
+                                                (Us &&) us...)))
+        {
+            version_node<T>* ptr = alloc_traits::allocate(alloc(), 1);
+#if LSTM_HAS_EXCEPTIONS
+            if (noexcept(alloc_traits::construct(alloc(), ptr, (Us &&) us...))) {
+                alloc_traits::construct(alloc(), ptr, (Us &&) us...);
+            } else {
+                try {
+                    alloc_traits::construct(alloc(), ptr, (Us &&) us...);
+                } catch (...) {
+                    alloc_traits::deallocate(alloc(), ptr, 1);
+                    throw;
+                }
+            }
+#else
+            alloc_traits::construct(alloc(), ptr, (Us &&) us...);
+#endif
+            return {static_cast<version_node_base*>(ptr)};
+        }
+
+        static void destroy_deallocate(node_alloc_type& alloc, var_storage s) noexcept
+        {
+            version_node<T>* ptr = node(s);
+            alloc_traits::destroy(alloc, ptr);
+            alloc_traits::deallocate(alloc, ptr, 1);
+        }
+
+        static version_node<T>* node(var_storage storage) noexcept
+        {
+            return static_cast<version_node<T>*>(static_cast<version_node_base*>(storage.ptr));
+        }
+
+        // links a node, that has not yet been published, to the node it is replacing
+        static void
+        link(var_storage storage, var_storage prev_storage, const epoch_t prev_version) noexcept
+        {
+            node(storage)->prev         = node(prev_storage);
+            node(storage)->prev_version = prev_version;
+        }
+
+        // links a node to what the unpublished node it replaces was linked to
+        static void relink(var_storage storage, var_storage replaced_storage) noexcept
+        {
+            node(storage)->prev         = node(replaced_storage)->prev;
+            node(storage)->prev_version = node(replaced_storage)->prev_version;
+        }
+
+        static T& load(var_storage storage) noexcept { return node(storage)->value; }
+
+        template<typename U>
+        static void
+        store(var_storage storage, U&& u) noexcept(std::is_nothrow_assignable<T&, U&&>{})
+        {
+            load(storage) = (U &&) u;
+        }
+    };
+LSTM_DETAIL_END
+
+#endif /* LSTM_DETAIL_MULTI_VERSION_VAR_DETAIL_HPP */
@@ -23,6 +23,8 @@
     #define LSTM_PERF_STATS_BLOOM_COLLISIONS()  ++lstm::detail::tls_record().bloom_collisions
     #define LSTM_PERF_STATS_BLOOM_SUCCESSES()   ++lstm::detail::tls_record().bloom_successes
     #define LSTM_PERF_STATS_BACKOFFS()          ++lstm::detail::tls_record().backoffs
+    #define LSTM_PERF_STATS_DUPLICATE_READS()   ++lstm::detail::tls_record().duplicate_reads
+    #define LSTM_PERF_STATS_ABORT_CAUSE(cause)  ++lstm::detail::tls_record().abort_causes[static_cast<std::size_t>(cause)]
     #define LSTM_PERF_STATS_PUBLISH_RECORD()                                                       \
         do {                                                                                       \
             lstm::detail::perf_stats::get().publish(lstm::detail::tls_record());                   \
@@ -75,12 +77,33 @@
 #ifndef LSTM_PERF_STATS_BACKOFFS
     #define LSTM_PERF_STATS_BACKOFFS() /**/
 #endif
+#ifndef LSTM_PERF_STATS_DUPLICATE_READS
+    #define LSTM_PERF_STATS_DUPLICATE_READS() /**/
+#endif
+#ifndef LSTM_PERF_STATS_ABORT_CAUSE
+    #define LSTM_PERF_STATS_ABORT_CAUSE(cause) /**/
+#endif
 
 // clang-format on
 
 #ifdef LSTM_PERF_STATS_ON
 
 LSTM_DETAIL_BEGIN
+    // one failure count per lstm::abort_cause
+    constexpr std::size_t abort_cause_count = 7;
+
+    inline const char* abort_cause_label(const std::size_t cause) noexcept
+    {
+        static constexpr const char* labels[abort_cause_count] = {"Unknown Aborts:        ",
+                                                                  "Read Conflicts:        ",
+                                                                  "Write Conflicts:       ",
+                                                                  "Lock Conflicts:        ",
+                                                                  "Validation Failures:   ",
+                                                                  "Irrevocable Failures:  ",
+                                                                  "Retries:               "};
+        return labels[cause];
+    }
+
     struct perf_stats_tls_record
     {
         std::uint64_t reads{0};
@@ -94,6 +117,8 @@ LSTM_DETAIL_BEGIN
         std::uint64_t bloom_collisions{0};
         std::uint64_t bloom_successes{0};
         std::uint64_t backoffs{0};
+        std::uint64_t duplicate_reads{0};
+        std::uint64_t abort_causes[abort_cause_count]{};
 
         perf_stats_tls_record() noexcept = default;
 
@@ -115,6 +140,10 @@ LSTM_DETAIL_BEGIN
         auto average_read_size() const noexcept { return reads / float(transactions()); }
         auto average_write_size() const noexcept { return writes / float(transactions()); }
         auto backoff_rate() const noexcept { return backoffs / float(transactions()); }
+        auto read_dedup_rate() const noexcept
+        {
+            return duplicate_reads / float(reads + duplicate_reads);
+        }
 
         std::string results() const
         {
@@ -129,10 +158,12 @@ LSTM_DETAIL_BEGIN
                  << "    Max Write Size:        " << max_write_size << '\n'
                  << "    Max Read Size:         " << max_read_size << '\n'
                  << "    Bloom Collision Rate:  " << bloom_collision_rate() << '\n'
+                 << "    Read Dedup Rate:       " << read_dedup_rate() << '\n'
                  << "    Reads:                 " << reads << '\n'
                  << "    Writes:                " << writes << '\n'
                  << "    Quiesces:              " << quiesces << '\n'
                  << "    Backoffs:              " << backoffs << '\n'
+                 << "    Duplicate Reads:       " << duplicate_reads << '\n'
                  << "    Successes:             " << successes << '\n'
                  << "    Failures:              " << failures << '\n'
                  << "    Internal Failure Rate: " << internal_failure_rate() << '\n'
@@ -142,6 +173,8 @@ LSTM_DETAIL_BEGIN
                  << "    Bloom Collisions:      " << bloom_collisions << '\n'
                  << "    Bloom Successes:       " << bloom_successes << '\n'
                  << "    Bloom Checks:          " << bloom_checks() << '\n';
+            for (std::size_t cause = 0; cause < abort_cause_count; ++cause)
+                ostr << "    " << abort_cause_label(cause) << abort_causes[cause] << '\n';
             return ostr.str();
         }
     };
@@ -222,6 +255,16 @@ LSTM_DETAIL_BEGIN
             return total_count(&perf_stats_tls_record::bloom_successes);
         }
         auto backoffs() const noexcept { return total_count(&perf_stats_tls_record::backoffs); }
+        auto duplicate_reads() const noexcept
+        {
+            return total_count(&perf_stats_tls_record::duplicate_reads);
+        }
+        auto aborts(const std::size_t cause) const noexcept
+        {
+            return total_count([cause](const perf_stats_tls_record* record) {
+                return record->abort_causes[cause];
+            });
+        }
         auto internal_failures() const noexcept { return failures() - user_failures(); }
         auto transactions() const noexcept { return failures() + successes(); }
         auto success_rate() const noexcept { return successes() / float(transactions()); }
@@ -240,6 +283,10 @@ LSTM_DETAIL_BEGIN
         auto average_read_size() const noexcept { return reads() / float(transactions()); }
         auto average_write_size() const noexcept { return writes() / float(transactions()); }
         auto backoff_rate() const noexcept { return backoffs() / float(transactions()); }
+        auto read_dedup_rate() const noexcept
+        {
+            return duplicate_reads() / float(reads() + duplicate_reads());
+        }
 
         std::size_t thread_count() const noexcept { return records_.size(); }
 
@@ -260,10 +307,12 @@ LSTM_DETAIL_BEGIN
                  << "Max Write Size:        " << max_write_size() << '\n'
                  << "Max Read Size:         " << max_read_size() << '\n'
                  << "Bloom Collision Rate:  " << bloom_collision_rate() << '\n'
+                 << "Read Dedup Rate:       " << read_dedup_rate() << '\n'
                  << "Reads:                 " << reads() << '\n'
                  << "Writes:                " << writes() << '\n'
                  << "Quiesces:              " << quiesces() << '\n'
                  << "Backoffs:              " << backoffs() << '\n'
+                 << "Duplicate Reads:       " << duplicate_reads() << '\n'
                  << "Successes:             " << successes() << '\n'
                  << "Failures:              " << failures() << '\n'
                  << "Internal Failure Rate: " << internal_failure_rate() << '\n'
@@ -273,6 +322,8 @@ LSTM_DETAIL_BEGIN
                  << "Bloom Collisions:      " << bloom_collisions() << '\n'
                  << "Bloom Successes:       " << bloom_successes() << '\n'
                  << "Bloom Checks:          " << bloom_checks() << '\n';
+            for (std::size_t cause = 0; cause < abort_cause_count; ++cause)
+                ostr << abort_cause_label(cause) << aborts(cause) << '\n';
 
             if (per_thread) {
                 std::size_t i = 0;
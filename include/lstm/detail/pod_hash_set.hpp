@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 LSTM_DETAIL_BEGIN
     template<typename T>
@@ -30,6 +31,42 @@ LSTM_DETAIL_BEGIN
         return (one << (raw_hash & 63));
     }
 
+#ifndef LSTM_BLOOM_HASHES
+    template<typename T>
+    inline hash_t reference_hash(const T& value) noexcept
+    {
+        return dumb_reference_hash(value);
+    }
+
+    inline bool may_contain(const hash_t filter, const hash_t hash) noexcept
+    {
+        return filter & hash;
+    }
+#else
+    static_assert(LSTM_BLOOM_HASHES > 0 && LSTM_BLOOM_HASHES <= 10,
+                  "LSTM_BLOOM_HASHES must be between 1 and 10");
+
+    // sets LSTM_BLOOM_HASHES bits, each from a different 6 bit window of a fibonacci hash of the
+    // address. unlike dumb_reference_hash, vars allocated a fixed stride apart spread over the
+    // whole filter
+    template<typename T>
+    inline hash_t reference_hash(const T& value) noexcept
+    {
+        constexpr hash_t one{1};
+        const hash_t     raw_hash = reinterpret_cast<std::uintptr_t>(&value) >> calcShift<T>();
+        const hash_t     mixed    = raw_hash * hash_t(0x9E3779B97F4A7C15ull);
+        hash_t           result   = 0;
+        for (int i = 0; i < LSTM_BLOOM_HASHES; ++i)
+            result |= one << ((mixed >> (58 - 6 * i)) & 63);
+        return result;
+    }
+
+    inline bool may_contain(const hash_t filter, const hash_t hash) noexcept
+    {
+        return (filter & hash) == hash;
+    }
+#endif /* LSTM_BLOOM_HASHES */
+
     // this class is only designed to work with write_set_value_type and read_set_value_type
     template<typename Underlying>
     struct pod_hash_set
@@ -45,19 +82,92 @@ LSTM_DETAIL_BEGIN
         using const_iterator  = typename data_t::const_iterator;
 
     private:
-        hash_t filter_;
-        data_t data;
+        using index_alloc_traits =
+            typename std::allocator_traits<allocator_type>::template rebind_traits<uword>;
+        using index_allocator_type = typename index_alloc_traits::allocator_type;
+
+        // sets this large are searched through an open addressing index, instead of a linear scan
+        static constexpr uword index_threshold = 32;
+        static constexpr uword min_index_bits  = 6;
+
+        hash_t               filter_;
+        data_t               data;
+        index_allocator_type index_alloc;
+        // one past the position in data of each element, or 0 for an empty slot. the index is
+        // built by the first search that needs it, kept up to date by pushes until it is half
+        // full, and dropped on anything else that changes data
+        uword*               index;
+        uword                index_bits;
+        bool                 indexed;
+
+        uword index_capacity() const noexcept { return index ? uword(1) << index_bits : 0; }
+
+        // fibonacci hashing, as the low bits of addresses are mostly alignment
+        uword index_slot(const var_base& value) const noexcept
+        {
+            const uword address = reinterpret_cast<std::uintptr_t>(&value) >> calcShift<var_base>();
+            const uword hash    = address * uword(0x9E3779B97F4A7C15ull);
+            return hash >> (sizeof(uword) * 8 - index_bits);
+        }
 
-        iterator find_impl(const var_base& value) noexcept LSTM_PURE
+        void index_insert(const uword position) noexcept
         {
-            iterator              result = begin();
-            const var_base* const ptr    = &value;
-            while (result != end() && ptr != &result->dest_var())
-                ++result;
-            return result;
+            const uword mask = index_capacity() - 1;
+            uword       slot = index_slot(data.begin()[position].dest_var());
+            while (index[slot])
+                slot = (slot + 1) & mask;
+            index[slot] = position + 1;
         }
 
-        const_iterator find_slow_path(const var_base& dest_var) const noexcept LSTM_PURE
+        LSTM_NOINLINE void build_index() noexcept
+        {
+            uword bits = min_index_bits;
+            while ((uword(1) << bits) < size() * 4)
+                ++bits;
+            if (bits != index_bits || !index) {
+                if (index)
+                    index_alloc_traits::deallocate(index_alloc, index, index_capacity());
+                index      = index_alloc_traits::allocate(index_alloc, uword(1) << bits);
+                index_bits = bits;
+            }
+            std::memset(index, 0, sizeof(uword) * index_capacity());
+            for (uword position = 0; position != size(); ++position)
+                index_insert(position);
+            indexed = true;
+        }
+
+        iterator find_impl(const var_base& value) noexcept
+        {
+            const var_base* const ptr = &value;
+            if (size() < index_threshold) {
+                iterator result = begin();
+                while (result != end() && ptr != &result->dest_var())
+                    ++result;
+                return result;
+            }
+
+            if (!indexed)
+                build_index();
+            const uword mask = index_capacity() - 1;
+            for (uword slot = index_slot(value);; slot = (slot + 1) & mask) {
+                const uword entry = index[slot];
+                if (!entry)
+                    return end();
+                if (ptr == &data.begin()[entry - 1].dest_var())
+                    return begin() + (entry - 1);
+            }
+        }
+
+        // keeps the index up to date with an element just pushed
+        void index_push() noexcept
+        {
+            if (size() * 2 > index_capacity())
+                indexed = false;
+            else
+                index_insert(size() - 1);
+        }
+
+        const_iterator find_slow_path(const var_base& dest_var) const noexcept
         {
             const const_iterator iter = const_cast<pod_hash_set&>(*this).find_impl(dest_var);
 
@@ -88,12 +198,22 @@ LSTM_DETAIL_BEGIN
         pod_hash_set(const allocator_type& alloc = {}) noexcept
             : filter_(0)
             , data(alloc)
+            , index_alloc(alloc)
+            , index(nullptr)
+            , index_bits(0)
+            , indexed(false)
         {
         }
 
         pod_hash_set(const pod_hash_set&) = delete;
         pod_hash_set& operator=(const pod_hash_set&) = delete;
 
+        ~pod_hash_set() noexcept
+        {
+            if (index)
+                index_alloc_traits::deallocate(index_alloc, index, index_capacity());
+        }
+
         hash_t filter() const noexcept { return filter_; }
         void reset_filter(const hash_t new_filter) noexcept { filter_ = new_filter; }
 
@@ -101,6 +221,17 @@ LSTM_DETAIL_BEGIN
         {
             filter_ = 0;
             data.clear();
+            indexed = false;
+        }
+
+        // drops every element pushed after the first new_size, and rebuilds the filter
+        void truncate(const uword new_size) noexcept
+        {
+            data.truncate(new_size);
+            indexed = false;
+            filter_ = 0;
+            for (const value_type& value : data)
+                filter_ |= reference_hash(value.dest_var());
         }
 
         bool  empty() const noexcept { return data.empty(); }
@@ -118,6 +249,8 @@ LSTM_DETAIL_BEGIN
 
             filter_ |= hash;
             data.emplace_back(value, pending_write);
+            if (LSTM_UNLIKELY(indexed))
+                index_push();
         }
 
         void unchecked_push_back(
@@ -130,6 +263,8 @@ LSTM_DETAIL_BEGIN
 
             filter_ |= hash;
             data.unchecked_emplace_back(value, pending_write);
+            if (LSTM_UNLIKELY(indexed))
+                index_push();
         }
 
         void push_back(const var_base* const value,
@@ -138,6 +273,7 @@ LSTM_DETAIL_BEGIN
             LSTM_ASSERT(hash != 0);
             filter_ |= hash;
             data.emplace_back(value);
+            indexed = false;
         }
 
         void unchecked_push_back(const var_base* const value, const hash_t hash) noexcept(
@@ -146,12 +282,13 @@ LSTM_DETAIL_BEGIN
             LSTM_ASSERT(hash != 0);
             filter_ |= hash;
             data.unchecked_emplace_back(value);
+            indexed = false;
         }
 
         // biased against finding the var
         const_iterator find(const var_base& dest_var) const noexcept
         {
-            if (LSTM_LIKELY(!(filter_ & dumb_reference_hash(dest_var)))) {
+            if (LSTM_LIKELY(!may_contain(filter_, reference_hash(dest_var)))) {
                 if (!empty())
                     LSTM_PERF_STATS_BLOOM_SUCCESSES();
 
@@ -163,8 +300,8 @@ LSTM_DETAIL_BEGIN
         // biased against finding the var
         write_set_lookup lookup(const var_base& dest_var) noexcept
         {
-            const hash_t hash = dumb_reference_hash(dest_var);
-            if (LSTM_LIKELY(!(filter_ & hash))) {
+            const hash_t hash = reference_hash(dest_var);
+            if (LSTM_LIKELY(!may_contain(filter_, hash))) {
                 if (!empty())
                     LSTM_PERF_STATS_BLOOM_SUCCESSES();
 
@@ -173,10 +310,26 @@ LSTM_DETAIL_BEGIN
             return lookup_slow_path(dest_var, hash);
         }
 
-        void unordered_erase(const pointer ptr) noexcept { data.unordered_erase(ptr); }
-        void unordered_erase(const const_pointer ptr) noexcept { data.unordered_erase(ptr); }
+        void unordered_erase(const pointer ptr) noexcept
+        {
+            data.unordered_erase(ptr);
+            indexed = false;
+        }
+        void unordered_erase(const const_pointer ptr) noexcept
+        {
+            data.unordered_erase(ptr);
+            indexed = false;
+        }
 
-        void shrink_to_fit() noexcept(noexcept(data.shrink_to_fit())) { data.shrink_to_fit(); }
+        void shrink_to_fit() noexcept(noexcept(data.shrink_to_fit()))
+        {
+            data.shrink_to_fit();
+            if (index) {
+                index_alloc_traits::deallocate(index_alloc, index, index_capacity());
+                index   = nullptr;
+                indexed = false;
+            }
+        }
 
         iterator       begin() noexcept { return data.begin(); }
         iterator       end() noexcept { return data.end(); }
@@ -88,7 +88,20 @@ LSTM_DETAIL_BEGIN
             std::memmove((void*)ptr, --end_, sizeof(value_type));
         }
 
+        void swap(pod_vector& rhs) noexcept
+        {
+            std::swap(alloc(), rhs.alloc());
+            std::swap(end_, rhs.end_);
+            std::swap(begin_, rhs.begin_);
+            std::swap(last_valid_address_, rhs.last_valid_address_);
+        }
+
         void clear() noexcept { end_ = begin_; }
+        void truncate(const uword new_size) noexcept
+        {
+            LSTM_ASSERT(new_size <= size());
+            end_ = begin_ + new_size;
+        }
 
         LSTM_NOINLINE void shrink_to_fit() noexcept(has_noexcept_alloc)
         {
@@ -4,12 +4,15 @@
 #include <lstm/detail/gp_callback.hpp>
 #include <lstm/detail/pod_mallocator.hpp>
 
+#include <exception>
+
 LSTM_DETAIL_BEGIN
     struct quiescence_header
     {
-        epoch_t epoch;
-        uword   size;
-        uword   prev_size;
+        transaction_domain* domain;
+        epoch_t             epoch;
+        uword               size;
+        uword               prev_size;
     };
 
     union quiescence_buf_elem
@@ -63,7 +66,6 @@ LSTM_DETAIL_BEGIN
         uword wrap(const uword index) const noexcept { return index & (capacity() - 1); }
 
         uword size() const noexcept { return wrap(write_pos - ring_begin); }
-        uword working_epoch_size() const noexcept { return wrap(write_pos - epoch_begin); }
 
         LSTM_NOINLINE void reserve_more() noexcept(has_noexcept_alloc)
         {
@@ -120,12 +122,20 @@ LSTM_DETAIL_BEGIN
         {
             return wrap(write_pos - ring_begin) == last_valid_index;
         }
-        bool working_epoch_empty() const noexcept { return working_epoch_size() == 1; }
-        void clear_working_epoch() noexcept
+        // includes the header of the epoch
+        uword working_epoch_size() const noexcept { return wrap(write_pos - epoch_begin); }
+        bool  working_epoch_empty() const noexcept { return working_epoch_size() == 1; }
+        void  clear_working_epoch() noexcept
         {
             LSTM_ASSERT(size() >= working_epoch_size());
             write_pos = epoch_begin + 1;
         }
+        // drops the callbacks pushed after the working epoch had new_size callbacks
+        void truncate_working_epoch(const uword new_size) noexcept
+        {
+            LSTM_ASSERT(new_size >= 1 && new_size <= working_epoch_size());
+            write_pos = epoch_begin + new_size;
+        }
 
         template<typename... Us>
         void emplace_back(Us&&... us) noexcept(has_noexcept_alloc)
@@ -144,17 +154,26 @@ LSTM_DETAIL_BEGIN
             ::new (&buffer[wrap(write_pos++)].callback) gp_callback((Us &&) us...);
         }
 
-        void shrink_to_fit() noexcept(has_noexcept_alloc) { throw "TODO"; }
+        void shrink_to_fit() noexcept(has_noexcept_alloc)
+        {
+#if LSTM_HAS_EXCEPTIONS
+            throw "TODO";
+#else
+            std::terminate();
+#endif
+        }
 
         // TODO: make this smaller
-        bool finalize_epoch(const epoch_t epoch) noexcept(has_noexcept_alloc)
+        bool finalize_epoch(transaction_domain& domain,
+                            const epoch_t       epoch) noexcept(has_noexcept_alloc)
         {
             if (working_epoch_empty())
                 return false;
 
             LSTM_ASSERT(working_epoch_size() > 1);
 
-            buffer[epoch_begin].header.epoch = epoch;
+            buffer[epoch_begin].header.domain = &domain;
+            buffer[epoch_begin].header.epoch  = epoch;
             buffer[epoch_begin].header.size  = working_epoch_size();
 
             const uword prev_size = working_epoch_size();
@@ -197,6 +216,25 @@ LSTM_DETAIL_BEGIN
             LSTM_ASSERT(!empty());
             return buffer[ring_begin].header.epoch;
         }
+
+        // nullptr once the domain has been forgotten
+        transaction_domain* front_domain() const noexcept
+        {
+            LSTM_ASSERT(!empty());
+            return buffer[ring_begin].header.domain;
+        }
+
+        // the domain has been destroyed. its epochs are left without a domain, and nothing is
+        // waited on to reclaim them
+        void forget_domain(const transaction_domain& domain) noexcept
+        {
+            uword idx = ring_begin;
+            while (idx != epoch_begin) {
+                if (buffer[idx].header.domain == &domain)
+                    buffer[idx].header.domain = nullptr;
+                idx = wrap(idx + buffer[idx].header.size);
+            }
+        }
     };
 LSTM_DETAIL_END
 
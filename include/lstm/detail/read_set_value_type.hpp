@@ -8,14 +8,23 @@ LSTM_DETAIL_BEGIN
     {
     private:
         const var_base* src_var_;
+#ifdef LSTM_NOREC
+        var_storage observed_;
+#endif
 
         inline read_set_value_type() noexcept = default;
 
     public:
-        inline read_set_value_type(const var_base* const in_src_var) noexcept
+        // the storage that was read is only kept for value based validation
+        inline read_set_value_type(const var_base* const in_src_var,
+                                   const var_storage     in_observed) noexcept
             : src_var_(in_src_var)
+#ifdef LSTM_NOREC
+            , observed_(in_observed)
+#endif
         {
             LSTM_ASSERT(src_var_);
+            (void)in_observed;
         }
 
         inline const var_base& src_var() const noexcept
@@ -29,6 +38,14 @@ LSTM_DETAIL_BEGIN
             LSTM_ASSERT(src_var_);
             return src_var_ == &rhs;
         }
+
+#ifdef LSTM_NOREC
+        inline var_storage observed() const noexcept
+        {
+            LSTM_ASSERT(src_var_);
+            return observed_;
+        }
+#endif
     };
 LSTM_DETAIL_END
 
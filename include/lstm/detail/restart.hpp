@@ -0,0 +1,99 @@
+#ifndef LSTM_DETAIL_RESTART_HPP
+#define LSTM_DETAIL_RESTART_HPP
+
+#include <lstm/detail/lstm_fwd.hpp>
+
+#ifdef LSTM_NO_EXCEPTIONS
+#include <csetjmp>
+
+#ifdef LSTM_USE_BOOST_FIBERS
+#include <boost/fiber/fss.hpp>
+#endif
+
+LSTM_DETAIL_BEGIN
+    // with LSTM_NO_EXCEPTIONS defined, an abort longjmps to the innermost restart point of the
+    // thread, where a tx_retry would otherwise be caught. nothing in between is unwound, so
+    // transactions must not hold anything that needs destroying across a read, write or retry
+    struct restart_point
+    {
+        std::jmp_buf   buf;
+        restart_point* prev;
+        abort_reason   reason;
+    };
+
+#ifndef LSTM_USE_BOOST_FIBERS
+    inline restart_point*& tls_restart_point() noexcept
+    {
+        static LSTM_THREAD_LOCAL restart_point* point = nullptr;
+        return point;
+    }
+#else
+    inline restart_point*& tls_restart_point() noexcept
+    {
+        static boost::fibers::fiber_specific_ptr<restart_point*> point_ptr;
+        if (point_ptr.get() == nullptr)
+            point_ptr.reset(::new restart_point*(nullptr));
+        return *point_ptr;
+    }
+#endif /* LSTM_USE_BOOST_FIBERS */
+
+    // keeps point innermost while in scope. the restart pops point before jumping to it, as this
+    // is skipped when a restart jumps past it
+    struct restart_scope
+    {
+        restart_point& point;
+
+        explicit restart_scope(restart_point& in_point) noexcept
+            : point(in_point)
+        {
+            point.prev          = tls_restart_point();
+            tls_restart_point() = &point;
+        }
+
+        restart_scope(const restart_scope&) = delete;
+        restart_scope& operator=(const restart_scope&) = delete;
+
+        ~restart_scope() { tls_restart_point() = point.prev; }
+    };
+
+    [[noreturn]] inline void restart(const abort_reason reason) noexcept
+    {
+        restart_point* const point = tls_restart_point();
+        LSTM_ASSERT(point);
+        tls_restart_point() = point->prev;
+        point->reason       = reason;
+        std::longjmp(point->buf, 1);
+    }
+LSTM_DETAIL_END
+
+// clang-format off
+// an attempt at a transaction. aborts end up in reason, and anything else thrown in the handler
+// that follows LSTM_CATCH_ATTEMPT
+#define LSTM_TRY_ATTEMPT(reason)                                                                   \
+    ::lstm::detail::restart_point       lstm_restart_point_;                                       \
+    const ::lstm::detail::restart_scope lstm_restart_scope_{lstm_restart_point_};                  \
+    if (setjmp(lstm_restart_point_.buf) != 0)                                                      \
+        reason = lstm_restart_point_.reason;                                                       \
+    else LSTM_TRY_ATTEMPT_BODY                                                                     \
+    /**/
+#if LSTM_HAS_EXCEPTIONS
+    #define LSTM_TRY_ATTEMPT_BODY try
+    #define LSTM_CATCH_ATTEMPT(reason) catch (...)
+#else
+    // nothing else can be thrown, so the handler is never run
+    #define LSTM_TRY_ATTEMPT_BODY if (true)
+    #define LSTM_CATCH_ATTEMPT(reason) else
+#endif
+#else
+#define LSTM_TRY_ATTEMPT(reason) try
+#define LSTM_CATCH_ATTEMPT(reason)                                                                 \
+    catch (const ::lstm::detail::tx_retry& lstm_failure_)                                          \
+    {                                                                                              \
+        reason = lstm_failure_.reason;                                                             \
+    }                                                                                              \
+    catch (...)                                                                                    \
+    /**/
+// clang-format on
+#endif /* LSTM_NO_EXCEPTIONS */
+
+#endif /* LSTM_DETAIL_RESTART_HPP */
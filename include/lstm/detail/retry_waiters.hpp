@@ -0,0 +1,228 @@
+#ifndef LSTM_DETAIL_RETRY_WAITERS_HPP
+#define LSTM_DETAIL_RETRY_WAITERS_HPP
+
+#include <lstm/thread_data.hpp>
+
+#include <bitset>
+
+#ifndef LSTM_USE_BOOST_FIBERS
+#include <condition_variable>
+#include <mutex>
+#else
+#include <boost/fiber/condition_variable.hpp>
+#include <boost/fiber/mutex.hpp>
+#endif
+
+LSTM_DETAIL_BEGIN
+#ifndef LSTM_USE_BOOST_FIBERS
+    using retry_mutex     = std::mutex;
+    using retry_condition = std::condition_variable;
+#else
+    using retry_mutex     = boost::fibers::mutex;
+    using retry_condition = boost::fibers::condition_variable;
+#endif
+
+    // a thread blocked in lstm::retry. lives on the stack of that thread
+    struct retry_waiter
+    {
+        transaction_domain*      domain;
+        thread_data*             td;
+        // the reference_hash of every var the failed attempt read, or'd together
+        hash_t                   reads;
+        // set if reads has too many bits to go by. the read set is then kept in td, and searched
+        bool                     saturated;
+        // the commit that wakes the thread, once its writes are published
+        std::atomic<const void*> waker;
+        bool                     woken;
+        retry_mutex              mutex;
+        retry_condition          condition;
+        retry_waiter*            next;
+    };
+
+    // threads blocked in lstm::retry sleep until a commit writes to one of the vars they read. each
+    // domain keeps the hashes of those vars, which commits check after locking their writes, so
+    // only commits that write to a var with a blocked reader walk the waiters of the domain
+    struct retry_waiters
+    {
+    private:
+        static constexpr std::size_t hash_bits = sizeof(hash_t) * 8;
+
+        // a hash with more than half of its bits set matches most writes. the waiter would be woken
+        // by nearly every commit, and take every commit through the list
+        static bool saturated(const hash_t reads) noexcept
+        {
+            return std::bitset<hash_bits>(reads).count() > hash_bits / 2;
+        }
+
+        // whether a var the waiter read is one writes_to says the commit writes. only compares
+        // addresses, as the vars may have been freed since the waiter left its critical section
+        template<typename WritesTo>
+        static bool
+        reads_written(const retry_waiter& waiter, const hash_t writes, const WritesTo& writes_to)
+        {
+            for (const read_set_value_type read_set_value : waiter.td->retry_read_set) {
+                if ((reference_hash(read_set_value.src_var()) & writes)
+                    && writes_to(read_set_value))
+                    return true;
+            }
+            return false;
+        }
+
+        // unlinks the waiters pred picks, and returns them linked to each other. takes the
+        // retry_lock of the domain, and leaves the hashes of the rest in retry_waits
+        template<typename Pred>
+        static retry_waiter* remove_if(transaction_domain& domain, const Pred& pred) noexcept
+        {
+            retry_waiter* removed   = nullptr;
+            hash_t        remaining = 0;
+            domain.retry_lock.lock();
+            for (retry_waiter** iter = &domain.retry_head; *iter;) {
+                retry_waiter* const waiter = *iter;
+                if (pred(*waiter)) {
+                    *iter        = waiter->next;
+                    waiter->next = removed;
+                    removed      = waiter;
+                } else {
+                    remaining |= waiter->reads;
+                    iter = &waiter->next;
+                }
+            }
+            domain.retry_waits.store(remaining, LSTM_RELAXED);
+            domain.retry_lock.unlock();
+            return removed;
+        }
+
+        // locked vars are treated as changed, unless the failed attempt owns them. under
+        // LSTM_NOREC, any commit since the reads were last validated counts
+        static bool reads_changed(const thread_data&             tls_td,
+                                  const thread_data::read_set_t& read_set) noexcept
+        {
+#ifndef LSTM_NOREC
+            for (const read_set_value_type read_set_value : read_set) {
+                const epoch_t version = read_set_value.src_var().version_lock.load(LSTM_RELAXED);
+                if (version > tls_td.tx_version && version != tls_td.tx_owner_lock)
+                    return true;
+            }
+            return false;
+#else
+            (void)read_set;
+            return tls_td.domain().load_sequence_lock() != tls_td.tx_version;
+#endif
+        }
+
+        // fails if a commit already removed the waiter to wake it. the waiter must then wait for
+        // that, as the commit may still notify it
+        static bool cancel(retry_waiter& waiter) noexcept
+        {
+            if (!remove_if(*waiter.domain, [&](const retry_waiter& w) { return &w == &waiter; }))
+                return false;
+            // the failed attempt still cleans up its read set
+            if (waiter.saturated)
+                waiter.td->read_set.swap(waiter.td->retry_read_set);
+            return true;
+        }
+
+    public:
+        // registers the failed attempt as blocked on its read set, unless a var in it has already
+        // changed. called before the attempt leaves its critical section, as vars may be freed
+        // afterwards
+        static bool prepare(thread_data& tls_td, retry_waiter& waiter) noexcept
+        {
+            hash_t reads = 0;
+            for (const read_set_value_type read_set_value : tls_td.read_set)
+                reads |= reference_hash(read_set_value.src_var());
+            // nothing could ever wake it
+            if (!reads)
+                return false;
+
+            waiter.domain    = &tls_td.domain();
+            waiter.td        = &tls_td;
+            waiter.reads     = reads;
+            waiter.saturated = saturated(reads);
+            waiter.waker.store(nullptr, LSTM_RELAXED);
+            waiter.woken = false;
+            if (waiter.saturated)
+                tls_td.read_set.swap(tls_td.retry_read_set);
+
+            transaction_domain& domain = *waiter.domain;
+            domain.retry_lock.lock();
+            waiter.next       = domain.retry_head;
+            domain.retry_head = &waiter;
+            domain.retry_waits.fetch_or(reads, LSTM_SEQ_CST);
+            domain.retry_lock.unlock();
+            // pairs with the load of retry_waits commits make after locking their writes. either
+            // the commit sees the hashes, or the write is seen here as locked
+            std::atomic_thread_fence(LSTM_SEQ_CST);
+
+            return !reads_changed(tls_td,
+                                  waiter.saturated ? tls_td.retry_read_set : tls_td.read_set)
+                   || !cancel(waiter);
+        }
+
+        // called outside of a critical section, so that commits may still reclaim memory. the
+        // commit that wakes the thread has already removed it
+        static void wait(retry_waiter& waiter) noexcept
+        {
+            {
+                std::unique_lock<retry_mutex> lock{waiter.mutex};
+                waiter.condition.wait(lock, [&] { return waiter.woken; });
+            }
+            if (waiter.saturated)
+                waiter.td->retry_read_set.clear();
+        }
+
+        // picks out the threads blocked on any of the vars a commit writes, for wake(domain, waker)
+        // to wake once the writes are published. writes is the reference_hash of those vars, and
+        // writes_to(read_set_value) whether the commit writes to the var of read_set_value
+        template<typename WritesTo>
+        static bool mark(transaction_domain& domain,
+                         const hash_t        writes,
+                         const WritesTo&     writes_to,
+                         const void* const   waker) noexcept
+        {
+            bool marked = false;
+            domain.retry_lock.lock_shared();
+            for (retry_waiter* waiter = domain.retry_head; waiter; waiter = waiter->next) {
+                if (!(waiter->reads & writes) || waiter->waker.load(LSTM_RELAXED)
+                    || (waiter->saturated && !reads_written(*waiter, writes, writes_to)))
+                    continue;
+                const void* unmarked = nullptr;
+                marked |= waiter->waker.compare_exchange_strong(unmarked, waker, LSTM_RELAXED);
+            }
+            domain.retry_lock.unlock_shared();
+            return marked;
+        }
+
+        // wakes the threads marked by the commit of waker. they are removed first, and only
+        // notified once the lock is released, as they would otherwise wake up to wait on it
+        static void wake(transaction_domain& domain, const void* const waker) noexcept
+        {
+            retry_waiter* woken = remove_if(domain, [&](const retry_waiter& waiter) {
+                return waiter.waker.load(LSTM_RELAXED) == waker;
+            });
+
+            // a waiter may return as soon as it sees woken, so next is read first
+            while (woken) {
+                retry_waiter* const next = woken->next;
+                {
+                    std::lock_guard<retry_mutex> guard{woken->mutex};
+                    woken->woken = true;
+                    woken->condition.notify_one();
+                }
+                woken = next;
+            }
+        }
+
+        // wakes the threads blocked on v, once a commit that writes only v has published it
+        static void wake(transaction_domain& domain, const var_base& v) noexcept
+        {
+            if (mark(domain,
+                     reference_hash(v),
+                     [&](const read_set_value_type read) { return read.is_src_var(v); },
+                     &v))
+                wake(domain, &v);
+        }
+    };
+LSTM_DETAIL_END
+
+#endif /* LSTM_DETAIL_RETRY_WAITERS_HPP */
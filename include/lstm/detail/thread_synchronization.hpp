@@ -19,6 +19,101 @@ LSTM_DETAIL_BEGIN
     inline bool locked(const epoch_t version) noexcept { return version & lock_bit; }
     inline epoch_t as_locked(const epoch_t version) noexcept { return version | lock_bit; }
 
+    // constant initialized, and never destroyed, as domains with static storage duration may be
+    // destroyed after it otherwise would be
+    struct domain_retirement_list
+    {
+        union
+        {
+            mutex_type mut;
+        };
+        domain_retirement* head;
+
+        constexpr domain_retirement_list() noexcept
+            : mut()
+            , head(nullptr)
+        {
+        }
+
+        ~domain_retirement_list() noexcept {}
+    };
+
+    LSTM_INLINE_VAR domain_retirement_list global_domain_retirement_list{};
+
+    // tells a thread about the domains destroyed while it had reclamation queued. nothing can still
+    // be running in those domains, so the thread reclaims what it queued for them without waiting.
+    // reclamation holds the list's lock shared while it uses a domain, which keeps the domain alive
+    struct domain_retirement
+    {
+    private:
+        domain_retirement* next;
+        // the domains destroyed since the thread last looked. guarded by the list's lock
+        pod_vector<const transaction_domain*> domains;
+        std::atomic<bool>                     retired;
+        // set by the thread while it has reclamation queued. only those threads are told
+        std::atomic<bool>                     queued;
+
+        static domain_retirement_list& list() noexcept
+        {
+            return LSTM_ACCESS_INLINE_VAR(global_domain_retirement_list);
+        }
+
+    public:
+        domain_retirement() noexcept
+            : retired(false)
+            , queued(false)
+        {
+            list().mut.lock();
+            next        = list().head;
+            list().head = this;
+            list().mut.unlock();
+        }
+
+        domain_retirement(const domain_retirement&) = delete;
+        domain_retirement& operator=(const domain_retirement&) = delete;
+
+        ~domain_retirement() noexcept
+        {
+            list().mut.lock();
+            domain_retirement** link = &list().head;
+            while (*link != this)
+                link = &(*link)->next;
+            *link = next;
+            domains.clear();
+            list().mut.unlock();
+        }
+
+        static void retire(const transaction_domain& domain) noexcept
+        {
+            list().mut.lock();
+            for (domain_retirement* thread = list().head; thread; thread = thread->next) {
+                if (thread->queued.load(LSTM_RELAXED)) {
+                    thread->domains.emplace_back(&domain);
+                    thread->retired.store(true, LSTM_RELAXED);
+                }
+            }
+            list().mut.unlock();
+        }
+
+        static void lock_shared() noexcept { list().mut.lock_shared(); }
+        static void unlock_shared() noexcept { list().mut.unlock_shared(); }
+
+        bool retired_any() const noexcept { return retired.load(LSTM_RELAXED); }
+        void set_queued(const bool in_queued) noexcept { queued.store(in_queued, LSTM_RELAXED); }
+
+        // calls forget with each of the domains destroyed since the last call
+        template<typename F>
+        void forget_retired(F&& forget) noexcept
+        {
+            list().mut.lock();
+            for (const transaction_domain* domain : domains)
+                forget(*domain);
+            domains.clear();
+            retired.store(false, LSTM_RELAXED);
+            list().mut.unlock();
+        }
+    };
+
     template<std::size_t CacheLineOffset>
     struct thread_synchronization_list
     {
@@ -45,10 +140,18 @@ LSTM_DETAIL_BEGIN
                                                                 : LSTM_CACHE_LINE_SIZE];
         };
 
+        // the domain is published alongside the epoch so that reclamation in one domain never waits
+        // on threads running transactions in another
+        struct active_state
+        {
+            std::atomic<epoch_t>             epoch;
+            std::atomic<transaction_domain*> domain;
+        };
+
         union
         {
-            std::atomic<epoch_t> active;
-            char                 padding3_[LSTM_CACHE_LINE_SIZE];
+            active_state active;
+            char         padding3_[LSTM_CACHE_LINE_SIZE];
         };
 
         static void lock_all() noexcept
@@ -70,23 +173,28 @@ LSTM_DETAIL_BEGIN
         }
 
         LSTM_NOINLINE static void
-        wait_on_epoch(const epoch_t epoch, const thread_synchronization_node* const node) noexcept
+        wait_on_epoch(const transaction_domain&                domain,
+                      const epoch_t                            epoch,
+                      const thread_synchronization_node* const node) noexcept
         {
             default_backoff backoff;
             do {
                 backoff();
-            } while (node->epoch_less_equal_to(epoch));
+            } while (node->epoch_less_equal_to(domain, epoch));
         }
 
-        static epoch_t wait_min_epoch(const epoch_t epoch) noexcept
+        static epoch_t wait_min_epoch(const transaction_domain& domain,
+                                      const epoch_t             epoch) noexcept
         {
             epoch_t result = off_state;
             for (const thread_synchronization_node* node :
                  global_synchronization_list<CacheLineOffset>.nodes) {
-                const epoch_t td_epoch = node->active.load(LSTM_ACQUIRE);
+                const epoch_t td_epoch = node->active.epoch.load(LSTM_ACQUIRE);
+                if (node->active.domain.load(LSTM_ACQUIRE) != &domain)
+                    continue;
 
                 if (LSTM_UNLIKELY(td_epoch <= epoch))
-                    wait_on_epoch(epoch, node);
+                    wait_on_epoch(domain, epoch, node);
                 else if (td_epoch < result)
                     result = td_epoch;
             }
@@ -99,7 +207,7 @@ LSTM_DETAIL_BEGIN
     public:
         thread_synchronization_node() noexcept
             : mut()
-            , active(off_state)
+            , active{{off_state}, {nullptr}}
         {
             LSTM_ASSERT(std::uintptr_t(this) % LSTM_CACHE_LINE_SIZE == CacheLineOffset);
             LSTM_ASSERT(std::uintptr_t(&active) % LSTM_CACHE_LINE_SIZE == 0);
@@ -135,19 +243,26 @@ LSTM_DETAIL_BEGIN
             mut.unlock();
         }
 
-        inline epoch_t epoch() const noexcept { return active.load(LSTM_RELAXED); }
+        inline epoch_t epoch() const noexcept { return active.epoch.load(LSTM_RELAXED); }
+
+        // the domain of the current, or most recent critical section
+        inline transaction_domain* domain() const noexcept
+        {
+            return active.domain.load(LSTM_RELAXED);
+        }
 
         inline bool in_critical_section() const noexcept
         {
-            return active.load(LSTM_RELAXED) != off_state;
+            return active.epoch.load(LSTM_RELAXED) != off_state;
         }
 
-        inline void access_lock(const epoch_t epoch) noexcept
+        inline void access_lock(transaction_domain& domain, const epoch_t epoch) noexcept
         {
             LSTM_ASSERT(!in_critical_section());
             LSTM_ASSERT(epoch != off_state);
 
-            active.store(epoch, LSTM_RELEASE);
+            active.domain.store(&domain, LSTM_RELEASE);
+            active.epoch.store(epoch, LSTM_RELEASE);
             std::atomic_thread_fence(LSTM_ACQUIRE);
         }
 
@@ -155,26 +270,29 @@ LSTM_DETAIL_BEGIN
         {
             LSTM_ASSERT(in_critical_section());
             LSTM_ASSERT(epoch != off_state);
-            LSTM_ASSERT(active.load(LSTM_RELAXED) <= epoch);
+            LSTM_ASSERT(active.epoch.load(LSTM_RELAXED) <= epoch);
 
-            active.store(epoch, LSTM_RELEASE);
+            active.epoch.store(epoch, LSTM_RELEASE);
             std::atomic_thread_fence(LSTM_ACQUIRE);
         }
 
         inline void access_unlock() noexcept
         {
             LSTM_ASSERT(in_critical_section());
-            active.store(off_state, LSTM_RELEASE);
+            active.epoch.store(off_state, LSTM_RELEASE);
         }
 
-        bool epoch_less_equal_to(const epoch_t epoch) const noexcept
+        bool epoch_less_equal_to(const transaction_domain& domain, const epoch_t epoch) const
+            noexcept
         {
             // TODO: acquire seems unneeded
-            return active.load(LSTM_ACQUIRE) <= epoch;
+            return active.epoch.load(LSTM_ACQUIRE) <= epoch
+                   && active.domain.load(LSTM_ACQUIRE) == &domain;
         }
 
         // TODO: allow specifying a backoff strategy
-        epoch_t synchronize_min_epoch(const epoch_t epoch) const noexcept
+        epoch_t synchronize_min_epoch(const transaction_domain& domain, const epoch_t epoch) const
+            noexcept
         {
             LSTM_ASSERT(!in_critical_section());
             LSTM_ASSERT(epoch != off_state);
@@ -183,7 +301,7 @@ LSTM_DETAIL_BEGIN
 
             mut.lock_shared();
             {
-                result = wait_min_epoch(epoch);
+                result = wait_min_epoch(domain, epoch);
             }
             mut.unlock_shared();
 
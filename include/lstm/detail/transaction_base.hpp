@@ -1,47 +1,152 @@
 #ifndef LSTM_DETAIL_TRANSACTION_BASE_HPP
 #define LSTM_DETAIL_TRANSACTION_BASE_HPP
 
+#include <lstm/detail/multi_version_var_detail.hpp>
+#include <lstm/detail/restart.hpp>
 #include <lstm/thread_data.hpp>
 
 LSTM_DETAIL_BEGIN
-    [[noreturn]] LSTM_NOINLINE inline void internal_retry() { throw tx_retry{}; }
+    [[noreturn]] LSTM_NOINLINE inline void internal_retry()
+    {
+#ifndef LSTM_NO_EXCEPTIONS
+        throw tx_retry{abort_reason::conflict};
+#else
+        restart(abort_reason::conflict);
+#endif
+    }
 
     struct transaction_base
     {
     private:
+        using read_set_const_iter  = thread_data::read_set_t::const_iterator;
         using write_set_const_iter = thread_data::write_set_t::const_iterator;
 
         thread_data* tls_td;
         epoch_t      version_;
+#ifdef LSTM_NOREC
+        // the domain the transaction started in. its sequence lock stands in for the version of
+        // every var, and is read without looking up thread_data
+        const transaction_domain* domain_;
+#endif
+
+        [[noreturn]] LSTM_NOINLINE void internal_retry(const abort_cause cause,
+                                                       const var_base&   v) const
+        {
+            tls_td->set_abort_cause(cause, &v);
+            detail::internal_retry();
+        }
 
         /*************************/
         /* read write operations */
         /*************************/
+        // snapshot extension: a var newer than the transaction only forces a retry if something the
+        // transaction has already read or written has also changed. otherwise, the version is moved
+        // up to the current clock. transactions that have made reads that are never revalidated are
+        // not extended, and the epoch reclamation waits on is left untouched. irrevocable
+        // transactions are valid at every version, so the conflict is a locked var that they wait
+        // out before trying again
+#ifndef LSTM_NOREC
+        LSTM_NOINLINE bool rw_extend(const epoch_t conflicting_version) const noexcept
+        {
+            LSTM_ASSERT(tls_td->in_read_write_transaction());
+            LSTM_ASSERT(!rw_valid(conflicting_version));
+
+            if (LSTM_UNLIKELY(tls_td->tx_irrevocable)) {
+                yield{}();
+                return true;
+            }
+
+            if (locked(conflicting_version) || tls_td->tx_unvalidated_reads)
+                return false;
+
+            transaction_domain& domain = tls_td->domain();
+            // lazy clocks may not have moved up to the conflicting write yet
+            domain.advance_past(conflicting_version - 1);
+            const epoch_t new_version = domain.get_clock();
+            if (new_version < conflicting_version)
+                return false;
+
+            for (const read_set_value_type read_set_value : tls_td->read_set) {
+                if (!rw_valid_or_owned(read_set_value.src_var()))
+                    return false;
+            }
+            // the storage each write replaces was captured at write time
+            for (const write_set_value_type write_set_value : tls_td->write_set) {
+                if (!rw_valid(write_set_value.dest_var()))
+                    return false;
+            }
+
+            tls_td->tx_version = new_version;
+            return true;
+        }
+#else
+        // value based validation: every var in the read set must still hold the storage that was
+        // read from it. the clock is rechecked afterwards, as a commit may have run in the middle
+        LSTM_NOINLINE bool rw_extend(const epoch_t conflicting_version) const noexcept
+        {
+            LSTM_ASSERT(tls_td->in_read_write_transaction());
+            LSTM_ASSERT(!rw_valid(conflicting_version));
+            (void)conflicting_version;
+
+            if (tls_td->tx_unvalidated_reads)
+                return false;
+
+            const transaction_domain& domain = tls_td->domain();
+            while (true) {
+                const epoch_t new_version = domain.get_clock();
+                for (const read_set_value_type read_set_value : tls_td->read_set) {
+                    if (read_set_value.src_var().storage.load(LSTM_ACQUIRE).ptr
+                        != read_set_value.observed().ptr)
+                        return false;
+                }
+                if (LSTM_LIKELY(domain.load_sequence_lock() == new_version)) {
+                    tls_td->tx_version = new_version;
+                    return true;
+                }
+            }
+        }
+#endif
+
         LSTM_NOINLINE_LUKEWARM var_storage rw_read_slow_path(const var_base& src_var) const
         {
+            // encounter time locking writes in place, so owned vars need no write set lookup
+            if (rw_owns(src_var))
+                return src_var.storage.load(LSTM_RELAXED);
+
             const write_set_const_iter iter = tls_td->write_set.find(src_var);
             if (iter == tls_td->write_set.end()) {
-                const var_storage result = src_var.storage.load(LSTM_ACQUIRE);
-                if (rw_valid(src_var.version_lock.load(LSTM_ACQUIRE))) {
-                    tls_td->read_set.emplace_back(&src_var);
-                    return result;
+                while (true) {
+                    const var_storage result  = src_var.storage.load(LSTM_ACQUIRE);
+                    const epoch_t     version = var_version(src_var);
+                    if (rw_valid(version)) {
+                        if (!tls_td->in_read_set_cache(src_var))
+                            tls_td->read_set.emplace_back(&src_var, result);
+                        return rw_read_deferred(src_var, result);
+                    }
+                    if (!rw_extend(version))
+                        break;
                 }
             } else if (rw_valid(src_var)) {
                 return iter->pending_write();
             }
 
-            internal_retry();
+            internal_retry(abort_cause::read_conflict, src_var);
         }
 
+        // snapshot isolated transactions read as if untracked
         LSTM_NOINLINE_LUKEWARM var_storage rw_read_base(const var_base& src_var) const
         {
             LSTM_ASSERT(valid(tls_td));
 
+            if (LSTM_UNLIKELY(tls_td->snapshot_isolated()))
+                return rw_untracked_read_base(src_var);
+
             if (LSTM_LIKELY(!tls_td->read_set.allocates_on_next_push()
-                            && !(tls_td->write_set.filter() & dumb_reference_hash(src_var)))) {
+                            && !may_contain(tls_td->write_set.filter(), reference_hash(src_var)))) {
                 const var_storage result = src_var.storage.load(LSTM_ACQUIRE);
-                if (LSTM_LIKELY(rw_valid(src_var.version_lock.load(LSTM_ACQUIRE)))) {
-                    tls_td->read_set.unchecked_emplace_back(&src_var);
+                if (LSTM_LIKELY(rw_valid(var_version(src_var)))) {
+                    if (!tls_td->in_read_set_cache(src_var))
+                        tls_td->read_set.unchecked_emplace_back(&src_var, result);
                     return result;
                 }
             }
@@ -57,10 +162,16 @@ LSTM_DETAIL_BEGIN
         {
             const write_set_lookup lookup = tls_td->write_set.lookup(dest_var);
             if (LSTM_LIKELY(!lookup.success())) {
-                const var_storage cur_storage = dest_var.storage.load(LSTM_ACQUIRE);
-                if (LSTM_LIKELY(rw_valid(dest_var.version_lock.load(LSTM_ACQUIRE)))) {
+                var_storage cur_storage = dest_var.storage.load(LSTM_ACQUIRE);
+                epoch_t     version     = var_version(dest_var);
+                while (!rw_valid(version) && rw_extend(version)) {
+                    cur_storage = dest_var.storage.load(LSTM_ACQUIRE);
+                    version     = var_version(dest_var);
+                }
+                if (LSTM_LIKELY(rw_valid(version))) {
                     const var_storage new_storage = dest_var.allocate_construct((U &&) u);
                     tls_td->add_write_set(dest_var, new_storage, lookup.hash());
+                    rw_replaces(dest_var, cur_storage);
                     sometime_synchronized_after(
                         [ alloc = dest_var.alloc(), cur_storage ]() mutable noexcept {
                             var<T, Alloc>::destroy_deallocate(alloc, cur_storage);
@@ -71,24 +182,137 @@ LSTM_DETAIL_BEGIN
                     return;
                 }
             } else if (rw_valid(dest_var)) {
-                var<T>::store(lookup.pending_write(), (U &&) u);
+                if (LSTM_UNLIKELY(tls_td->tx_savepoints))
+                    lookup.pending_write() = rw_savepoint_replace(dest_var,
+                                                                  lookup.pending_write(),
+                                                                  (U &&) u);
+                else
+                    var<T>::store(lookup.pending_write(), (U &&) u);
                 return;
             }
 
-            internal_retry();
+            internal_retry(abort_cause::write_conflict, dest_var);
+        }
+
+#ifndef LSTM_NOREC
+        // takes ownership of dest_var for the rest of the transaction, and logs the storage it held
+        // so that it can be restored if the transaction fails
+        LSTM_NOINLINE_LUKEWARM var_storage rw_encounter_time_lock(var_base& dest_var) const
+        {
+            LSTM_ASSERT(!rw_owns(dest_var));
+
+            epoch_t version = dest_var.version_lock.load(LSTM_RELAXED);
+            while (true) {
+                if (rw_valid(version)) {
+                    if (dest_var.version_lock.compare_exchange_weak(version,
+                                                                    tls_td->tx_owner_lock,
+                                                                    LSTM_SEQ_CST,
+                                                                    LSTM_RELAXED)) {
+                        const var_storage prev_storage = dest_var.storage.load(LSTM_RELAXED);
+                        tls_td->undo_log.emplace_back(&dest_var, prev_storage);
+                        return prev_storage;
+                    }
+                } else if (rw_extend(version)) {
+                    version = dest_var.version_lock.load(LSTM_RELAXED);
+                } else {
+                    internal_retry(abort_cause::write_conflict, dest_var);
+                }
+            }
+        }
+
+        // other transactions never dereference the storage of a locked var, so owned vars are
+        // written in place
+        template<typename T,
+                 typename Alloc,
+                 typename U = T,
+                 LSTM_REQUIRES_(!var<T, Alloc>::atomic && std::is_assignable<T&, U&&>()
+                                && std::is_constructible<T, U&&>())>
+        LSTM_NOINLINE_LUKEWARM void rw_encounter_time_write(var<T, Alloc>& dest_var, U&& u) const
+        {
+            if (rw_owns(dest_var)) {
+                const var_storage cur_storage = dest_var.storage.load(LSTM_RELAXED);
+                if (LSTM_UNLIKELY(tls_td->tx_savepoints))
+                    dest_var.storage.store(rw_savepoint_replace(dest_var, cur_storage, (U &&) u),
+                                           LSTM_RELEASE);
+                else
+                    var<T, Alloc>::store(cur_storage, (U &&) u);
+                return;
+            }
+            if (LSTM_UNLIKELY(rw_buffers_write(dest_var)))
+                return rw_write_slow_path(dest_var, (U &&) u);
+
+            const var_storage new_storage = dest_var.allocate_construct((U &&) u);
+            after_fail([ alloc = dest_var.alloc(), new_storage ]() mutable noexcept {
+                var<T, Alloc>::destroy_deallocate(alloc, new_storage);
+            });
+            const var_storage cur_storage = rw_encounter_time_lock(dest_var);
+            sometime_synchronized_after(
+                [ alloc = dest_var.alloc(), cur_storage ]() mutable noexcept {
+                    var<T, Alloc>::destroy_deallocate(alloc, cur_storage);
+                });
+            dest_var.storage.store(new_storage, LSTM_RELEASE);
+        }
+
+        LSTM_NOINLINE_LUKEWARM void
+        rw_encounter_time_atomic_write(var_base& dest_var, const var_storage storage) const
+        {
+            if (!rw_owns(dest_var)) {
+                if (LSTM_UNLIKELY(rw_buffers_write(dest_var)))
+                    return rw_atomic_write_slow_path(dest_var, storage);
+                rw_encounter_time_lock(dest_var);
+            } else if (LSTM_UNLIKELY(tls_td->tx_savepoints)) {
+                tls_td->savepoint_log.emplace_back(&dest_var,
+                                                   dest_var.storage.load(LSTM_RELAXED));
+            }
+            dest_var.storage.store(storage, LSTM_RELEASE);
+        }
+
+        // a var only unlocks by publishing a new version, so vars are never locked while a
+        // savepoint is active. the writes are buffered in the write set instead, as are any later
+        // writes to the var
+        bool rw_buffers_write(const var_base& dest_var) const noexcept
+        {
+            return tls_td->tx_savepoints
+                   || may_contain(tls_td->write_set.filter(), reference_hash(dest_var));
+        }
+#endif
+
+        // inside lstm::or_else, storage that was current when a savepoint was taken must survive
+        // until the savepoint is released. a write to it allocates new storage instead, and logs
+        // the replaced storage so that rolling back to the savepoint can restore it
+        template<typename Var, typename U>
+        var_storage rw_savepoint_replace(Var& dest_var, const var_storage cur_storage, U&& u) const
+        {
+            const var_storage new_storage = dest_var.allocate_construct((U &&) u);
+            after_fail([ alloc = dest_var.alloc(), new_storage ]() mutable noexcept {
+                Var::destroy_deallocate(alloc, new_storage);
+            });
+            tls_td->savepoint_log.emplace_back(&static_cast<var_base&>(dest_var), cur_storage);
+            sometime_synchronized_after(
+                [ alloc = dest_var.alloc(), cur_storage ]() mutable noexcept {
+                    Var::destroy_deallocate(alloc, cur_storage);
+                });
+            return new_storage;
         }
 
         LSTM_NOINLINE_LUKEWARM void
         rw_atomic_write_slow_path(var_base& dest_var, const var_storage storage) const
         {
             const write_set_lookup lookup = tls_td->write_set.lookup(dest_var);
-            if (LSTM_LIKELY(!lookup.success()))
+            if (LSTM_LIKELY(!lookup.success())) {
+                // extend before adding dest_var, as extension validates the write set
+                const epoch_t version = var_version(dest_var, LSTM_RELAXED);
+                if (!rw_valid(version) && !rw_extend(version))
+                    internal_retry(abort_cause::write_conflict, dest_var);
                 tls_td->add_write_set(dest_var, storage, lookup.hash());
-            else
+            } else {
+                if (LSTM_UNLIKELY(tls_td->tx_savepoints))
+                    tls_td->savepoint_log.emplace_back(&dest_var, lookup.pending_write());
                 lookup.pending_write() = storage;
+            }
 
             if (!rw_valid(dest_var))
-                internal_retry();
+                internal_retry(abort_cause::write_conflict, dest_var);
         }
 
         // atomic var's perform no allocation (therefore, no callbacks)
@@ -97,7 +321,12 @@ LSTM_DETAIL_BEGIN
         {
             LSTM_ASSERT(valid(tls_td));
 
-            const hash_t hash = dumb_reference_hash(dest_var);
+#ifndef LSTM_NOREC
+            if (tls_td->encounter_time_locking())
+                return rw_encounter_time_atomic_write(dest_var, storage);
+#endif
+
+            const hash_t hash = reference_hash(dest_var);
 
             if (LSTM_UNLIKELY(tls_td->write_set.allocates_on_next_push()
                               || (tls_td->write_set.filter() & hash)
@@ -107,28 +336,87 @@ LSTM_DETAIL_BEGIN
                 tls_td->add_write_set_unchecked(dest_var, storage, hash);
         }
 
+        LSTM_NOINLINE var_storage rw_read_deferred_slow_path(const var_base&   src_var,
+                                                             const var_storage storage) const
+        {
+            const thread_data::deferred_iter iter = tls_td->find_deferred(src_var);
+            if (iter == tls_td->deferred_log.end())
+                return storage;
+
+            const var_storage result = iter->apply(storage);
+            rw_atomic_write_slow_path(iter->dest_var(), result);
+            return result;
+        }
+
+        // a read of a var with a deferred update buffers the updated storage as a write instead.
+        // the update itself stays logged until the commit drops it, as restoring a savepoint may
+        // discard the write
+        var_storage rw_read_deferred(const var_base& src_var, const var_storage storage) const
+        {
+            if (LSTM_LIKELY(tls_td->deferred_log.empty()))
+                return storage;
+            return rw_read_deferred_slow_path(src_var, storage);
+        }
+
+        // deferred updates are recorded only for vars the transaction has not written. under
+        // encounter time locking, or while a savepoint is active, they read and write the var
+        LSTM_NOINLINE_LUKEWARM void rw_defer_base(var_base&         dest_var,
+                                                  const var_storage operand,
+                                                  const deferred_fn apply) const
+        {
+            LSTM_ASSERT(valid(tls_td));
+
+            if (LSTM_LIKELY(!tls_td->encounter_time_locking() && !tls_td->tx_savepoints)
+                && tls_td->write_set.find(dest_var) == tls_td->write_set.end()) {
+                const thread_data::deferred_iter iter = tls_td->find_deferred(dest_var);
+                if (iter == tls_td->deferred_log.end()) {
+                    tls_td->deferred_log.emplace_back(&dest_var, operand, apply);
+                    tls_td->write_set.reset_filter(tls_td->write_set.filter()
+                                                   | reference_hash(dest_var));
+                    return;
+                }
+                if (iter->applies(apply)) {
+                    iter->combine(operand);
+                    return;
+                }
+            }
+
+            rw_atomic_write_base(dest_var, apply(rw_read_base(dest_var), operand));
+        }
+
         LSTM_NOINLINE_LUKEWARM var_storage
         rw_untracked_read_slow_path(const var_base& src_var) const
         {
+            if (rw_owns(src_var))
+                return src_var.storage.load(LSTM_RELAXED);
+
             const write_set_const_iter iter = tls_td->write_set.find(src_var);
             if (iter == tls_td->write_set.end()) {
-                const var_storage result = src_var.storage.load(LSTM_ACQUIRE);
-                if (rw_valid(src_var.version_lock.load(LSTM_ACQUIRE)))
-                    return result;
+                // extension is disabled, so this only loops for irrevocable transactions
+                while (true) {
+                    const var_storage result  = src_var.storage.load(LSTM_ACQUIRE);
+                    const epoch_t     version = var_version(src_var);
+                    if (rw_valid(version))
+                        return rw_read_deferred(src_var, result);
+                    if (!rw_extend(version))
+                        break;
+                }
             } else if (rw_valid(src_var)) {
                 return iter->pending_write();
             }
 
-            internal_retry();
+            internal_retry(abort_cause::read_conflict, src_var);
         }
 
         var_storage rw_untracked_read_base(const var_base& src_var) const
         {
             LSTM_ASSERT(valid(tls_td));
 
-            if (LSTM_LIKELY(!(tls_td->write_set.filter() & dumb_reference_hash(src_var)))) {
+            disable_extension();
+
+            if (LSTM_LIKELY(!may_contain(tls_td->write_set.filter(), reference_hash(src_var)))) {
                 const var_storage result = src_var.storage.load(LSTM_ACQUIRE);
-                if (LSTM_LIKELY(rw_valid(src_var.version_lock.load(LSTM_ACQUIRE))))
+                if (LSTM_LIKELY(rw_valid(var_version(src_var))))
                     return result;
             }
             return rw_untracked_read_slow_path(src_var);
@@ -142,7 +430,7 @@ LSTM_DETAIL_BEGIN
             if (can_write())
                 return rw_read_base(src_var);
             else
-                internal_retry();
+                detail::internal_retry();
         }
 
         LSTM_NOINLINE_LUKEWARM var_storage ro_read_base(const var_base& src_var) const
@@ -151,7 +439,7 @@ LSTM_DETAIL_BEGIN
 
             if (LSTM_LIKELY(!can_write())) {
                 const var_storage result = src_var.storage.load(LSTM_ACQUIRE);
-                if (LSTM_LIKELY(rw_valid(src_var.version_lock.load(LSTM_ACQUIRE))))
+                if (LSTM_LIKELY(ro_valid(var_version(src_var))))
                     return result;
             }
             return ro_read_slow_path(src_var);
@@ -163,7 +451,7 @@ LSTM_DETAIL_BEGIN
             if (can_write())
                 return rw_untracked_read_base(src_var);
             else
-                internal_retry();
+                detail::internal_retry();
         }
 
         LSTM_NOINLINE_LUKEWARM var_storage ro_untracked_read_base(const var_base& src_var) const
@@ -172,42 +460,183 @@ LSTM_DETAIL_BEGIN
 
             if (LSTM_LIKELY(!can_write())) {
                 const var_storage result = src_var.storage.load(LSTM_ACQUIRE);
-                if (LSTM_LIKELY(rw_valid(src_var.version_lock.load(LSTM_ACQUIRE))))
+                if (LSTM_LIKELY(ro_valid(var_version(src_var))))
                     return result;
             }
             return ro_untracked_read_slow_path(src_var);
         }
 
+#ifndef LSTM_NOREC
+        // finds the storage src_var held at the version of the transaction. the storage and version
+        // pair is loaded as a seqlock would be, and the chain of replaced nodes is walked back from
+        // there. read only transactions publish their epoch before taking their version, so the
+        // commits that replaced those nodes are still waiting on this thread to reclaim them
+        LSTM_NOINLINE_LUKEWARM var_storage ro_history_read(const var_base& src_var) const
+        {
+            LSTM_ASSERT(!can_write());
+
+            var_storage result;
+            epoch_t     version = src_var.version_lock.load(LSTM_ACQUIRE);
+            while (true) {
+                // writes are only locked while committing, so wait it out
+                if (!locked(version)) {
+                    result                = src_var.storage.load(LSTM_ACQUIRE);
+                    const epoch_t recheck = src_var.version_lock.load(LSTM_ACQUIRE);
+                    if (LSTM_LIKELY(recheck == version))
+                        break;
+                    version = recheck;
+                } else {
+                    version = src_var.version_lock.load(LSTM_ACQUIRE);
+                }
+            }
+
+            version_node_base* node = static_cast<version_node_base*>(result.ptr);
+            while (!ro_valid(version)) {
+                LSTM_ASSERT(node->prev);
+                version = node->prev_version;
+                node    = node->prev;
+            }
+            return {node};
+        }
+
+        LSTM_NOINLINE_LUKEWARM var_storage
+        ro_multi_version_read_base(const var_base& src_var) const
+        {
+            LSTM_ASSERT(valid(tls_td));
+
+            if (LSTM_LIKELY(!can_write())) {
+                const var_storage result = src_var.storage.load(LSTM_ACQUIRE);
+                if (LSTM_LIKELY(ro_valid(src_var.version_lock.load(LSTM_ACQUIRE))))
+                    return result;
+                return ro_history_read(src_var);
+            }
+            return rw_read_base(src_var);
+        }
+
+        LSTM_NOINLINE_LUKEWARM var_storage
+        ro_multi_version_untracked_read_base(const var_base& src_var) const
+        {
+            LSTM_ASSERT(valid(tls_td));
+
+            if (LSTM_LIKELY(!can_write())) {
+                const var_storage result = src_var.storage.load(LSTM_ACQUIRE);
+                if (LSTM_LIKELY(ro_valid(src_var.version_lock.load(LSTM_ACQUIRE))))
+                    return result;
+                return ro_history_read(src_var);
+            }
+            return rw_untracked_read_base(src_var);
+        }
+#endif
+
     public:
-        inline transaction_base(thread_data* const in_tls_td, const epoch_t in_version) noexcept
+        inline transaction_base(thread_data* const        in_tls_td,
+                                const transaction_domain& in_domain,
+                                const epoch_t             in_version) noexcept
             : tls_td(in_tls_td)
             , version_(in_version)
+#ifdef LSTM_NOREC
+            , domain_(&in_domain)
+#endif
         {
+            (void)in_domain;
             LSTM_ASSERT(version_ != off_state);
             LSTM_ASSERT(!locked(version_));
         }
 
         thread_data& get_thread_data() const noexcept { return *tls_td; }
-        epoch_t      version() const noexcept { return version_; }
+
+        // read write transactions share their version through thread_data, so that every copy of
+        // the transaction sees snapshot extensions
+        epoch_t version() const noexcept { return tls_td ? tls_td->tx_version : version_; }
 
         bool can_write() const noexcept { return tls_td; }
-        bool can_demote_safely() const noexcept { return tls_td->write_set.empty(); }
+        // demoted transactions would retry on locked vars, which irrevocable transactions never do
+        bool can_demote_safely() const noexcept
+        {
+            return tls_td->write_set.empty() && tls_td->undo_log.empty()
+                   && tls_td->deferred_log.empty() && !tls_td->tx_irrevocable;
+        }
+
+        // reads that are never revalidated must all come from the same snapshot
+        void disable_extension() const noexcept { tls_td->tx_unvalidated_reads = true; }
 
         bool valid(const thread_data* td) const noexcept
         {
             if (td)
                 return ((!tls_td && td->tx_state != tx_kind::read_write)
                         || ((td == tls_td && td->tx_state != tx_kind::read_only)
-                            || td->write_set.empty()))
-                       && td->epoch() == version_ && td->in_transaction();
+                            || (td->write_set.empty() && td->undo_log.empty()
+                                && td->deferred_log.empty())))
+                       && td->epoch() <= version() && version() <= td->version()
+                       && td->in_transaction();
             else
                 return tls_td == nullptr;
         }
 
-        bool rw_valid(const epoch_t version) const noexcept { return version <= version_; }
+        // the version v was last written at. value based validation keeps no per var versions, so
+        // every var is treated as being as new as the clock
+        epoch_t var_version(const var_base& v, const std::memory_order order = LSTM_ACQUIRE) const
+            noexcept
+        {
+#ifndef LSTM_NOREC
+            return v.version_lock.load(order);
+#else
+            (void)v;
+            (void)order;
+            return domain_->load_sequence_lock();
+#endif
+        }
+
+        // the storage a write replaces must still be current when the transaction commits. per var
+        // versions are checked as the write set is locked. value based validation has the read set
+        void rw_replaces(const var_base& dest_var, const var_storage cur_storage) const
+        {
+#ifndef LSTM_NOREC
+            (void)dest_var;
+            (void)cur_storage;
+#else
+            tls_td->read_set.emplace_back(&dest_var, cur_storage);
+#endif
+        }
+
+        bool rw_valid(const epoch_t version) const noexcept
+        {
+            LSTM_ASSERT(tls_td);
+            return version <= tls_td->tx_version;
+        }
         bool rw_valid(const var_base& v) const noexcept
         {
-            return rw_valid(v.version_lock.load(LSTM_RELAXED));
+            return rw_valid(var_version(v, LSTM_RELAXED));
+        }
+
+        // only ever true under encounter time locking
+        bool rw_owns(const var_base& v) const noexcept
+        {
+#ifndef LSTM_NOREC
+            return tls_td->encounter_time_locking()
+                   && v.version_lock.load(LSTM_RELAXED) == tls_td->tx_owner_lock;
+#else
+            (void)v;
+            return false;
+#endif
+        }
+
+        // vars owned by the transaction were valid when they were locked
+        bool rw_valid_or_owned(const var_base& v) const noexcept
+        {
+            return rw_valid(v) || rw_owns(v);
+        }
+
+        bool ro_valid(const epoch_t version) const noexcept { return version <= version_; }
+        bool ro_valid(const var_base& v) const noexcept
+        {
+            return ro_valid(var_version(v, LSTM_RELAXED));
+        }
+
+        bool read_valid(const epoch_t version) const noexcept { return version <= this->version(); }
+        bool read_valid(const var_base& v) const noexcept
+        {
+            return read_valid(var_version(v, LSTM_RELAXED));
         }
 
         /*************************/
@@ -242,7 +671,12 @@ LSTM_DETAIL_BEGIN
         {
             LSTM_ASSERT(valid(tls_td));
 
-            const hash_t hash = dumb_reference_hash(dest_var);
+#ifndef LSTM_NOREC
+            if (tls_td->encounter_time_locking())
+                return rw_encounter_time_write(dest_var, (U &&) u);
+#endif
+
+            const hash_t hash = reference_hash(dest_var);
 
             if (LSTM_UNLIKELY(tls_td->write_set.allocates_on_next_push()
                               || (tls_td->write_set.filter() & hash)
@@ -254,6 +688,7 @@ LSTM_DETAIL_BEGIN
                 const var_storage new_storage = dest_var.allocate_construct((U &&) u);
                 tls_td->add_write_set_unchecked(dest_var, new_storage, hash);
                 const var_storage cur_storage = dest_var.storage.load(LSTM_RELAXED);
+                rw_replaces(dest_var, cur_storage);
                 tls_td->fail_callbacks.unchecked_emplace_back(
                     [ alloc = dest_var.alloc(), new_storage ]() mutable noexcept {
                         var<T, Alloc>::destroy_deallocate(alloc, new_storage);
@@ -275,6 +710,104 @@ LSTM_DETAIL_BEGIN
             rw_atomic_write_base(dest_var, dest_var.allocate_construct((U &&) u));
         }
 
+        // the storage of dest_var that only this transaction can see, if it has written dest_var
+        // already. that is the storage of a locked var, or of a buffered write. while a savepoint
+        // is active, that storage may be needed to restore it, so there is none
+        template<typename T, typename Alloc, LSTM_REQUIRES_(!var<T, Alloc>::atomic)>
+        T* rw_private_storage(var<T, Alloc>& dest_var) const noexcept
+        {
+            LSTM_ASSERT(valid(tls_td));
+
+            if (LSTM_UNLIKELY(tls_td->tx_savepoints))
+                return nullptr;
+#ifndef LSTM_NOREC
+            if (rw_owns(dest_var))
+                return &var<T, Alloc>::load(dest_var.storage.load(LSTM_RELAXED));
+#endif
+            if (!may_contain(tls_td->write_set.filter(), reference_hash(dest_var)))
+                return nullptr;
+            const write_set_lookup lookup = tls_td->write_set.lookup(dest_var);
+            if (!lookup.success() || !rw_valid(dest_var))
+                return nullptr;
+            return &var<T, Alloc>::load(lookup.pending_write());
+        }
+
+        // the first update copies the value, and later updates change that copy in place
+        template<typename T, typename Alloc, typename F, LSTM_REQUIRES_(!var<T, Alloc>::atomic)>
+        void rw_update(var<T, Alloc>& dest_var, F& f) const
+        {
+            if (T* const storage = rw_private_storage(dest_var)) {
+                f(*storage);
+                return;
+            }
+            T copy = rw_read(dest_var);
+            f(copy);
+            rw_write(dest_var, std::move(copy));
+        }
+
+#ifndef LSTM_NOREC
+        // writes to multi version vars are always buffered in the write set, as the node a write
+        // replaces is linked to before it is published
+        template<typename T,
+                 typename Alloc,
+                 typename U = T,
+                 LSTM_REQUIRES_(std::is_assignable<T&, U&&>() && std::is_constructible<T, U&&>())>
+        LSTM_NOINLINE_LUKEWARM void rw_write(multi_version_var<T, Alloc>& dest_var, U&& u) const
+        {
+            LSTM_ASSERT(valid(tls_td));
+
+            const write_set_lookup lookup = tls_td->write_set.lookup(dest_var);
+            if (LSTM_LIKELY(!lookup.success())) {
+                var_storage cur_storage = dest_var.storage.load(LSTM_ACQUIRE);
+                epoch_t     version     = dest_var.version_lock.load(LSTM_ACQUIRE);
+                while (!rw_valid(version) && rw_extend(version)) {
+                    cur_storage = dest_var.storage.load(LSTM_ACQUIRE);
+                    version     = dest_var.version_lock.load(LSTM_ACQUIRE);
+                }
+                if (LSTM_LIKELY(rw_valid(version))) {
+                    const var_storage new_storage = dest_var.allocate_construct((U &&) u);
+                    multi_version_var<T, Alloc>::link(new_storage, cur_storage, version);
+                    tls_td->add_write_set(dest_var, new_storage, lookup.hash());
+                    tls_td->tx_ordered_commit = true;
+                    sometime_synchronized_after(
+                        [ alloc = dest_var.alloc(), cur_storage ]() mutable noexcept {
+                            multi_version_var<T, Alloc>::destroy_deallocate(alloc, cur_storage);
+                        });
+                    after_fail([ alloc = dest_var.alloc(), new_storage ]() mutable noexcept {
+                        multi_version_var<T, Alloc>::destroy_deallocate(alloc, new_storage);
+                    });
+                    return;
+                }
+            } else if (rw_valid(dest_var)) {
+                if (LSTM_UNLIKELY(tls_td->tx_savepoints)) {
+                    const var_storage cur_storage = lookup.pending_write();
+                    const var_storage new_storage
+                        = rw_savepoint_replace(dest_var, cur_storage, (U &&) u);
+                    multi_version_var<T, Alloc>::relink(new_storage, cur_storage);
+                    lookup.pending_write() = new_storage;
+                } else {
+                    multi_version_var<T, Alloc>::store(lookup.pending_write(), (U &&) u);
+                }
+                return;
+            }
+
+            internal_retry(abort_cause::write_conflict, dest_var);
+        }
+
+        template<typename T, typename Alloc>
+        LSTM_ALWAYS_INLINE const T& rw_read(const multi_version_var<T, Alloc>& src_var) const
+        {
+            return multi_version_var<T, Alloc>::load(rw_read_base(src_var));
+        }
+
+        template<typename T, typename Alloc>
+        LSTM_ALWAYS_INLINE const T&
+        rw_untracked_read(const multi_version_var<T, Alloc>& src_var) const
+        {
+            return multi_version_var<T, Alloc>::load(rw_untracked_read_base(src_var));
+        }
+#endif
+
         template<typename T, typename Alloc, LSTM_REQUIRES_(!var<T, Alloc>::atomic)>
         LSTM_ALWAYS_INLINE const T& rw_untracked_read(const var<T, Alloc>& src_var) const
         {
@@ -293,6 +826,31 @@ LSTM_DETAIL_BEGIN
             return var<T, Alloc>::load(rw_untracked_read_base(src_var));
         }
 
+        // drops src_var from the read set, so it is no longer validated. vars the transaction has
+        // written stay in the read set, as value based validation checks the storage they replace
+        // through it. the read set cache trusts no position that stops holding its var
+        void rw_release(const var_base& src_var) const noexcept
+        {
+            LSTM_ASSERT(valid(tls_td));
+
+            if (tls_td->write_set.find(src_var) != tls_td->write_set.end())
+                return;
+
+            thread_data::read_set_t& read_set = tls_td->read_set;
+            for (read_set_const_iter read_iter = read_set.end(); read_iter != read_set.begin();) {
+                --read_iter;
+                if (read_iter->is_src_var(src_var))
+                    read_set.unordered_erase(read_iter);
+            }
+        }
+
+        // records a commutative update of dest_var by operand, without reading dest_var
+        template<typename T, typename Alloc, typename Op, LSTM_REQUIRES_(var<T, Alloc>::atomic)>
+        LSTM_ALWAYS_INLINE void rw_defer(var<T, Alloc>& dest_var, const T& operand, Op) const
+        {
+            rw_defer_base(dest_var, dest_var.allocate_construct(operand), &deferred_apply<T, Op>);
+        }
+
         /************************/
         /* read only operations */
         /************************/
@@ -332,6 +890,29 @@ LSTM_DETAIL_BEGIN
             return var<T, Alloc>::load(ro_untracked_read_base(src_var));
         }
 
+        // read only transactions only have a read set when nested in a read write transaction
+        void ro_release(const var_base& src_var) const noexcept
+        {
+            if (can_write())
+                rw_release(src_var);
+        }
+
+#ifndef LSTM_NOREC
+        template<typename T, typename Alloc>
+        LSTM_ALWAYS_INLINE const T& ro_read(const multi_version_var<T, Alloc>& src_var) const
+        {
+            return multi_version_var<T, Alloc>::load(ro_multi_version_read_base(src_var));
+        }
+
+        template<typename T, typename Alloc>
+        LSTM_ALWAYS_INLINE const T&
+        ro_untracked_read(const multi_version_var<T, Alloc>& src_var) const
+        {
+            return multi_version_var<T, Alloc>::load(
+                ro_multi_version_untracked_read_base(src_var));
+        }
+#endif
+
         template<typename Func, LSTM_REQUIRES_(std::is_constructible<gp_callback, Func&&>{})>
         void sometime_synchronized_after(Func&& func) const
             noexcept(noexcept(tls_td->sometime_synchronized_after((Func &&) func)))
@@ -348,6 +929,15 @@ LSTM_DETAIL_BEGIN
             LSTM_ASSERT(valid(tls_td));
             tls_td->after_fail((Func &&) func);
         }
+
+        template<typename Func, LSTM_REQUIRES_(std::is_constructible<gp_callback, Func&&>{})>
+        void after_commit(Func&& func) const
+            noexcept(noexcept(tls_td->after_commit((Func &&) func)))
+        {
+            LSTM_ASSERT(tls_td);
+            LSTM_ASSERT(valid(tls_td));
+            tls_td->after_commit((Func &&) func);
+        }
     };
 LSTM_DETAIL_END
 
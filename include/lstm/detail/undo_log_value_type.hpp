@@ -0,0 +1,38 @@
+#ifndef LSTM_DETAIL_UNDO_LOG_VALUE_TYPE_HPP
+#define LSTM_DETAIL_UNDO_LOG_VALUE_TYPE_HPP
+
+#include <lstm/detail/lstm_fwd.hpp>
+
+LSTM_DETAIL_BEGIN
+    struct undo_log_value_type
+    {
+    private:
+        var_base*   dest_var_;
+        var_storage prev_storage_;
+
+        inline undo_log_value_type() noexcept = default;
+
+    public:
+        inline undo_log_value_type(var_base* const   in_dest_var,
+                                   const var_storage in_prev_storage) noexcept
+            : dest_var_(in_dest_var)
+            , prev_storage_(in_prev_storage)
+        {
+            LSTM_ASSERT(dest_var_);
+        }
+
+        inline var_base& dest_var() const noexcept
+        {
+            LSTM_ASSERT(dest_var_);
+            return *dest_var_;
+        }
+
+        inline var_storage prev_storage() const noexcept
+        {
+            LSTM_ASSERT(dest_var_);
+            return prev_storage_;
+        }
+    };
+LSTM_DETAIL_END
+
+#endif /* LSTM_DETAIL_UNDO_LOG_VALUE_TYPE_HPP */
@@ -14,26 +14,33 @@ LSTM_BEGIN
 LSTM_END
 
 LSTM_DETAIL_BEGIN
+    // with LSTM_NOREC defined, transactions validate their reads by value against a single
+    // sequence lock per domain. vars then carry no version_lock, and shrink to a single word
     struct var_aligner
     {
-        std::atomic<epoch_t>     _dummy0;
+#ifndef LSTM_NOREC
+        std::atomic<epoch_t> _dummy0;
+#endif
         std::atomic<var_storage> _dummy1;
     };
 
-    struct alignas(alignof(var_aligner) << 1) var_base
+    struct alignas(sizeof(var_aligner)) var_base
     {
     protected:
-        std::atomic<epoch_t>     version_lock;
+#ifndef LSTM_NOREC
+        std::atomic<epoch_t> version_lock{0};
+#endif
         std::atomic<var_storage> storage;
 
         explicit var_base(const var_storage in_storage) noexcept
-            : version_lock{0}
-            , storage{in_storage}
+            : storage{in_storage}
         {
         }
 
         friend struct ::lstm::detail::transaction_base;
         friend commit_algorithm;
+        friend retry_waiters;
+        friend single_var_fn;
     };
 
     template<typename T>
@@ -127,6 +134,7 @@ LSTM_DETAIL_BEGIN
             && noexcept(alloc_traits::construct(alloc(), (T*)nullptr, (Us &&) us...)))
         {
             T* ptr = alloc_traits::allocate(alloc(), 1);
+#if LSTM_HAS_EXCEPTIONS
             if (noexcept(alloc_traits::construct(alloc(), ptr, (Us &&) us...))) {
                 alloc_traits::construct(alloc(), ptr, (Us &&) us...);
             } else {
@@ -137,6 +145,9 @@ LSTM_DETAIL_BEGIN
                     throw;
                 }
             }
+#else
+            alloc_traits::construct(alloc(), ptr, (Us &&) us...);
+#endif
             return {ptr};
         }
 
@@ -206,11 +217,12 @@ LSTM_DETAIL_BEGIN
         {
         }
 
+        // storage is zeroed first, so that equal values compare equal under value based validation
         template<typename... Us>
         var_storage
         allocate_construct(Us&&... us) noexcept(std::is_nothrow_constructible<T, Us&&...>{})
         {
-            var_storage result;
+            var_storage result{};
             alloc_traits::construct(alloc(), reinterpret_cast<T*>(result.raw), (Us &&) us...);
             return result;
         }
@@ -226,7 +238,7 @@ LSTM_DETAIL_BEGIN
         template<typename U>
         static void store(std::atomic<var_storage>& storage, U&& u) noexcept
         {
-            var_storage new_storage;
+            var_storage new_storage{};
             ::new (new_storage.raw) T((U &&) u);
             storage.store(new_storage, LSTM_RELAXED);
         }
@@ -0,0 +1,73 @@
+#ifndef LSTM_EFFECT_QUEUE_HPP
+#define LSTM_EFFECT_QUEUE_HPP
+
+#include <lstm/transaction.hpp>
+
+#include <vector>
+
+LSTM_BEGIN
+    // batches the side effects of the transactions run on one thread. an effect pushed by a
+    // transaction is kept only if it commits, and once batch_size effects are queued, the commit
+    // hands them all to the sink at once, oldest first. e.g. log lines can be written with a single
+    // writev per batch. the sink is called as sink(first, last), must not throw, and must not run
+    // transactions. an effect_queue belongs to a single thread
+    template<typename T, typename Sink, typename Alloc = std::allocator<T>>
+    struct effect_queue
+    {
+    private:
+        std::vector<T, Alloc> effects;
+        std::size_t           batch_size;
+        Sink                  sink;
+
+        void flush_full() noexcept
+        {
+            if (effects.size() >= batch_size)
+                flush();
+        }
+
+    public:
+        explicit effect_queue(const std::size_t in_batch_size,
+                              Sink              in_sink  = Sink{},
+                              const Alloc&      in_alloc = Alloc{})
+            : effects(in_alloc)
+            , batch_size(in_batch_size)
+            , sink(std::move(in_sink))
+        {
+            LSTM_ASSERT(batch_size > 0);
+            effects.reserve(batch_size);
+        }
+
+        effect_queue(const effect_queue&) = delete;
+        effect_queue& operator=(const effect_queue&) = delete;
+
+        ~effect_queue() { flush(); }
+
+        template<typename... Us>
+        void emplace(const transaction tx, Us&&... us)
+        {
+            // failures and restored savepoints drop the effects pushed since
+            const std::size_t size = effects.size();
+            tx.after_fail([this, size]() noexcept {
+                effects.erase(effects.begin() + size, effects.end());
+            });
+            effects.emplace_back((Us &&) us...);
+            tx.after_commit([this]() noexcept { flush_full(); });
+        }
+
+        void push(const transaction tx, const T& t) { emplace(tx, t); }
+        void push(const transaction tx, T&& t) { emplace(tx, std::move(t)); }
+
+        // hands every queued effect to the sink, however few there are
+        void flush() noexcept
+        {
+            if (effects.empty())
+                return;
+            sink(effects.data(), effects.data() + effects.size());
+            effects.clear();
+        }
+
+        std::size_t size() const noexcept { return effects.size(); }
+    };
+LSTM_END
+
+#endif /* LSTM_EFFECT_QUEUE_HPP */
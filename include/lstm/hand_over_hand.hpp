@@ -0,0 +1,63 @@
+#ifndef LSTM_HAND_OVER_HAND_HPP
+#define LSTM_HAND_OVER_HAND_HPP
+
+#include <lstm/multi_version_var.hpp>
+#include <lstm/var.hpp>
+
+#include <algorithm>
+
+LSTM_BEGIN
+    // reads the vars along a path through a linked structure, releasing each one once Size more
+    // have been read after it. only the tail of the path is then validated, so commits behind it
+    // no longer conflict with the traversal. vars the transaction writes are never released
+    template<std::size_t Size>
+    struct hand_over_hand
+    {
+        static_assert(Size > 0, "hand_over_hand must hold on to at least one var");
+
+    private:
+        transaction             tx;
+        const detail::var_base* window[Size];
+        std::size_t             next;
+
+        void hold(const detail::var_base& v) noexcept
+        {
+            const detail::var_base* const oldest = window[next];
+            window[next]                         = &v;
+            next                                 = (next + 1) % Size;
+
+            // a var read twice within the window is held until its last read leaves it
+            if (oldest && std::find(window, window + Size, oldest) == window + Size)
+                tx.release(*oldest);
+        }
+
+    public:
+        explicit hand_over_hand(const transaction in_tx) noexcept
+            : tx(in_tx)
+            , window{}
+            , next(0)
+        {
+        }
+
+        hand_over_hand(const hand_over_hand&) = delete;
+        hand_over_hand& operator=(const hand_over_hand&) = delete;
+
+        template<typename T, typename Alloc>
+        decltype(auto) get(const var<T, Alloc>& v)
+        {
+            decltype(auto) result = v.get(tx);
+            hold(v);
+            return result;
+        }
+
+        template<typename T, typename Alloc>
+        const T& get(const multi_version_var<T, Alloc>& v)
+        {
+            const T& result = v.get(tx);
+            hold(v);
+            return result;
+        }
+    };
+LSTM_END
+
+#endif /* LSTM_HAND_OVER_HAND_HPP */
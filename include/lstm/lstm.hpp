@@ -2,8 +2,15 @@
 #define LSTM_LSTM_HPP
 
 #include <lstm/atomic.hpp>
+#include <lstm/effect_queue.hpp>
+#include <lstm/hand_over_hand.hpp>
 #include <lstm/memory.hpp>
+#include <lstm/open_nested.hpp>
+#include <lstm/or_else.hpp>
 #include <lstm/retry.hpp>
+#include <lstm/single_var.hpp>
+#include <lstm/transaction_domain.hpp>
+#include <lstm/tx_object.hpp>
 #include <lstm/var.hpp>
 
 #endif /* LSTM_LSTM_HPP */
\ No newline at end of file
@@ -0,0 +1,172 @@
+#ifndef LSTM_MULTI_VERSION_VAR_HPP
+#define LSTM_MULTI_VERSION_VAR_HPP
+
+#include <lstm/detail/multi_version_var_detail.hpp>
+#include <lstm/read_transaction.hpp>
+#include <lstm/transaction.hpp>
+
+LSTM_BEGIN
+    // a var that keeps the values it held at previous versions for as long as a transaction might
+    // need them. read only transactions find the value that was current at their version, instead
+    // of retrying when the var has been written since they started. values are always heap
+    // allocated, and writes are always buffered until commit, even under encounter time locking
+    template<typename T, typename Alloc>
+    struct multi_version_var : private detail::multi_version_var_policy<T, Alloc>
+    {
+    private:
+        using base = detail::multi_version_var_policy<T, Alloc>;
+
+        friend struct ::lstm::detail::transaction_base;
+        template<std::size_t>
+        friend struct ::lstm::hand_over_hand;
+
+    public:
+        using value_type     = T;
+        using allocator_type = Alloc;
+
+        static_assert(std::is_same<allocator_type, detail::uncvref<allocator_type>>{},
+                      "lstm::multi_version_var<> allocators cannot be cv/ref qualified!");
+        static_assert(!std::is_reference<value_type>{},
+                      "lstm::multi_version_var<>'s cannot contain a reference");
+        static_assert(
+            std::is_same<detail::uncvref<value_type>, typename allocator_type::value_type>{},
+            "lstm::multi_version_var<> given invalid allocator for value_type");
+        static_assert(!std::is_const<value_type>{} && !std::is_volatile<value_type>{},
+                      "lstm::multi_version_var<> does not support cv qualifications on "
+                      "value_type");
+        static_assert(!std::is_array<value_type>{},
+                      "lstm::multi_version_var<> does not support raw c arrays. try using a "
+                      "std::array");
+#ifdef LSTM_NOREC
+        static_assert(!sizeof(value_type),
+                      "lstm::multi_version_var<> needs per var versions, which are not kept when "
+                      "LSTM_NOREC is defined");
+#endif
+
+        LSTM_REQUIRES(std::is_default_constructible<value_type>{}
+                      && std::is_default_constructible<allocator_type>{})
+        multi_version_var() noexcept(noexcept(base::allocate_construct())
+                                     && std::is_nothrow_default_constructible<allocator_type>{})
+        {
+        }
+
+        LSTM_REQUIRES(std::is_default_constructible<value_type>{})
+        multi_version_var(std::allocator_arg_t, const allocator_type& in_alloc) noexcept(
+            noexcept(base::allocate_construct()))
+            : base(std::allocator_arg, in_alloc)
+        {
+        }
+
+        template<typename U,
+                 typename... Us,
+                 LSTM_REQUIRES_(std::is_constructible<value_type, U&&, Us&&...>{}
+                                && detail::is_convertible<value_type, U&&, Us&&...>{}
+                                && !std::is_same<detail::uncvref<U>, std::allocator_arg_t>{}
+                                && std::is_default_constructible<allocator_type>{})>
+        multi_version_var(U&& u, Us&&... us) noexcept(
+            noexcept(base::allocate_construct((U &&) u, (Us &&) us...))
+            && std::is_nothrow_default_constructible<allocator_type>{})
+            : base((U &&) u, (Us &&) us...)
+        {
+        }
+
+        template<typename U,
+                 typename... Us,
+                 LSTM_REQUIRES_(std::is_constructible<value_type, U&&, Us&&...>{}
+                                && !detail::is_convertible<value_type, U&&, Us&&...>{}
+                                && !std::is_same<detail::uncvref<U>, std::allocator_arg_t>{}
+                                && std::is_default_constructible<allocator_type>{})>
+        explicit multi_version_var(U&& u, Us&&... us) noexcept(
+            noexcept(base::allocate_construct((U &&) u, (Us &&) us...))
+            && std::is_nothrow_default_constructible<allocator_type>{})
+            : base((U &&) u, (Us &&) us...)
+        {
+        }
+
+        template<typename U,
+                 typename... Us,
+                 LSTM_REQUIRES_(std::is_constructible<value_type, U&&, Us&&...>{})>
+        multi_version_var(std::allocator_arg_t,
+                          const allocator_type& in_alloc,
+                          U&&                   u,
+                          Us&&... us) noexcept(noexcept(base::allocate_construct((U &&) u,
+                                                                                 (Us &&) us...)))
+            : base(std::allocator_arg, in_alloc, (U &&) u, (Us &&) us...)
+        {
+        }
+
+        allocator_type get_allocator() const noexcept { return allocator_type(base::alloc()); }
+
+        const value_type& unsafe_get() const noexcept
+        {
+            return base::load(detail::var_base::storage.load(LSTM_RELAXED));
+        }
+
+        template<typename U = value_type, LSTM_REQUIRES_(std::is_assignable<value_type&, U&&>())>
+        void unsafe_set(U&& u) noexcept(
+            noexcept(base::store(detail::var_base::storage.load(LSTM_RELAXED), (U &&) u)))
+        {
+            base::store(detail::var_base::storage.load(LSTM_RELAXED), (U &&) u);
+        }
+
+        LSTM_ALWAYS_INLINE const value_type& get(const transaction tx) const
+        {
+            return tx.rw_read(*this);
+        }
+
+        LSTM_ALWAYS_INLINE const value_type& get(const read_transaction tx) const
+        {
+            return tx.ro_read(*this);
+        }
+
+        LSTM_ALWAYS_INLINE const value_type& untracked_get(const transaction tx) const
+        {
+            return tx.rw_untracked_read(*this);
+        }
+
+        LSTM_ALWAYS_INLINE const value_type& untracked_get(const read_transaction tx) const
+        {
+            return tx.ro_untracked_read(*this);
+        }
+
+        void release(const transaction tx) const noexcept
+        {
+            tx.release(static_cast<const detail::var_base&>(*this));
+        }
+
+        void release(const read_transaction tx) const noexcept
+        {
+            tx.release(static_cast<const detail::var_base&>(*this));
+        }
+
+        // whether info describes an attempt that failed on this var
+        bool caused(const contention_info& info) const noexcept
+        {
+            return info.var == static_cast<const detail::var_base*>(this);
+        }
+
+        template<typename U = value_type,
+                 LSTM_REQUIRES_(std::is_assignable<value_type&, U&&>()
+                                && std::is_constructible<value_type, U&&>())>
+        LSTM_ALWAYS_INLINE void set(const transaction tx, U&& u)
+        {
+            tx.rw_write(*this, (U &&) u);
+        }
+
+#ifndef LSTM_MAKE_SFINAE_FRIENDLY
+        template<typename U = value_type,
+                 LSTM_REQUIRES_(!std::is_assignable<value_type&, U&&>()
+                                || !std::is_constructible<value_type, U&&>())>
+        LSTM_ALWAYS_INLINE void set(const transaction, U&&)
+        {
+            static_assert(std::is_assignable<value_type&, U&&>(),
+                          "set requires lstm::multi_version_var<>::value_type be assignable by U");
+            static_assert(std::is_constructible<value_type, U&&>(),
+                          "set requires lstm::multi_version_var<>::value_type be constructible by "
+                          "U");
+        }
+#endif /* LSTM_MAKE_SFINAE_FRIENDLY */
+    };
+LSTM_END
+
+#endif /* LSTM_MULTI_VERSION_VAR_HPP */
@@ -0,0 +1,104 @@
+#ifndef LSTM_OPEN_NESTED_HPP
+#define LSTM_OPEN_NESTED_HPP
+
+#include <lstm/read_write.hpp>
+
+LSTM_DETAIL_BEGIN
+    // open nested transactions run on a thread_data of their own, so that the read and write sets
+    // of the transaction they are nested in are left untouched
+#ifndef LSTM_USE_BOOST_FIBERS
+    LSTM_NOINLINE inline thread_data& tls_open_nested_data() noexcept
+    {
+        static LSTM_THREAD_LOCAL thread_data tls_open_nested_data{tls_thread_data()};
+        return tls_open_nested_data;
+    }
+#else
+    LSTM_NOINLINE inline thread_data& tls_open_nested_data() noexcept
+    {
+        static boost::fibers::fiber_specific_ptr<thread_data> tls_open_nested_data_ptr;
+        if (tls_open_nested_data_ptr.get() == nullptr)
+            tls_open_nested_data_ptr.reset(::new thread_data(tls_thread_data()));
+        return *tls_open_nested_data_ptr;
+    }
+#endif /* LSTM_USE_BOOST_FIBERS */
+
+    // undoes a committed open nested transaction, with another one
+    template<typename Compensate>
+    struct compensation
+    {
+        transaction_domain* domain;
+        Compensate          compensate;
+
+        void operator()() noexcept
+        {
+            ::lstm::read_write(tls_open_nested_data(), *domain, compensate);
+        }
+    };
+
+    struct open_nested_fn : private detail::atomic_base_fn
+    {
+    private:
+        template<typename Func,
+                 typename Then,
+                 LSTM_REQUIRES_(std::is_void<transact_result<Func, transaction>>{})>
+        static void commit_then(transaction_domain& domain, Func&& func, Then then)
+        {
+            ::lstm::read_write(tls_open_nested_data(), domain, (Func &&) func);
+            then();
+        }
+
+        template<typename Func,
+                 typename Then,
+                 LSTM_REQUIRES_(!std::is_void<transact_result<Func, transaction>>{})>
+        static transact_result<Func, transaction>
+        commit_then(transaction_domain& domain, Func&& func, Then then)
+        {
+            transact_result<Func, transaction> result
+                = ::lstm::read_write(tls_open_nested_data(), domain, (Func &&) func);
+            then();
+            return static_cast<transact_result<Func, transaction>>(result);
+        }
+
+    public:
+        // runs func as a transaction of its own, which commits before this returns. the vars it
+        // accesses never enter the read or write set of tx, so they cause tx no conflicts. tx must
+        // not access those vars itself
+        template<typename Func, LSTM_REQUIRES_(is_transact_function<Func&&, transaction>())>
+        transact_result<Func, transaction> operator()(const transaction tx, Func&& func) const
+        {
+            thread_data& open_nested_data = tls_open_nested_data();
+            // nested in an open nested transaction, func simply joins it
+            if (&tx.get_thread_data() == &open_nested_data)
+                return call((Func &&) func, tx);
+
+            return ::lstm::read_write(open_nested_data, tx.domain(), (Func &&) func);
+        }
+
+        // if tx fails after func commits, compensate runs as an open nested transaction to undo
+        // func. compensations are stored like any other callback, so must be small and trivially
+        // copyable, and must not throw
+        template<typename Func,
+                 typename Compensate,
+                 LSTM_REQUIRES_(is_transact_function<Func&&, transaction>()
+                                && is_transact_function<Compensate&, transaction>())>
+        transact_result<Func, transaction>
+        operator()(const transaction tx, Func&& func, const Compensate compensate) const
+        {
+            if (&tx.get_thread_data() == &tls_open_nested_data())
+                return call((Func &&) func, tx);
+
+            return commit_then(tx.domain(), (Func &&) func, [&] {
+                tx.after_fail(compensation<Compensate>{&tx.domain(), compensate});
+            });
+        }
+    };
+LSTM_DETAIL_END
+
+LSTM_BEGIN
+    namespace
+    {
+        constexpr auto& open_nested = detail::static_const<detail::open_nested_fn>;
+    }
+LSTM_END
+
+#endif /* LSTM_OPEN_NESTED_HPP */
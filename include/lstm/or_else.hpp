@@ -0,0 +1,85 @@
+#ifndef LSTM_OR_ELSE_HPP
+#define LSTM_OR_ELSE_HPP
+
+#include <lstm/detail/restart.hpp>
+#include <lstm/read_write.hpp>
+
+LSTM_DETAIL_BEGIN
+    struct or_else_fn : private detail::atomic_base_fn
+    {
+    private:
+        struct savepoint_guard
+        {
+            thread_data& tls_td;
+
+            ~savepoint_guard() { commit_algorithm::release_savepoint(tls_td); }
+        };
+
+    public:
+        // runs first, and if it calls lstm::retry, discards its writes and runs second instead.
+        // the reads of first are kept, as the choice of second depends on them. if both retry, the
+        // whole transaction retries, and blocks on the vars either read. any other failure also
+        // fails the whole transaction
+        template<typename First,
+                 typename Second,
+                 typename Tx,
+                 LSTM_REQUIRES_(is_transact_function<First&&, Tx>()
+                                && is_transact_function<Second&&, Tx>())>
+        std::common_type_t<transact_result<First, Tx>, transact_result<Second, Tx>>
+        operator()(const Tx tx, First&& first, Second&& second) const
+        {
+            thread_data& tls_td = tls_thread_data();
+#ifndef LSTM_NO_EXCEPTIONS
+            // read only transactions have nothing to roll back
+            if (!tls_td.in_read_write_transaction()) {
+                try {
+                    return call((First &&) first, tx);
+                } catch (const tx_retry& failure) {
+                    if (failure.reason != abort_reason::retry)
+                        throw;
+                }
+            } else {
+                const savepoint sp = commit_algorithm::take_savepoint(tls_td);
+                try {
+                    const savepoint_guard guard{tls_td};
+                    return call((First &&) first, tx);
+                } catch (const tx_retry& failure) {
+                    if (failure.reason != abort_reason::retry)
+                        throw;
+                    commit_algorithm::restore_savepoint(tls_td, sp);
+                }
+            }
+#else
+            restart_point       point;
+            const restart_scope scope{point};
+            if (!tls_td.in_read_write_transaction()) {
+                if (setjmp(point.buf) == 0)
+                    return call((First &&) first, tx);
+                if (point.reason != abort_reason::retry)
+                    restart(point.reason);
+            } else {
+                const savepoint sp = commit_algorithm::take_savepoint(tls_td);
+                if (setjmp(point.buf) == 0) {
+                    const savepoint_guard guard{tls_td};
+                    return call((First &&) first, tx);
+                }
+                // the restart skipped the guard
+                commit_algorithm::release_savepoint(tls_td);
+                if (point.reason != abort_reason::retry)
+                    restart(point.reason);
+                commit_algorithm::restore_savepoint(tls_td, sp);
+            }
+#endif
+            return call((Second &&) second, tx);
+        }
+    };
+LSTM_DETAIL_END
+
+LSTM_BEGIN
+    namespace
+    {
+        constexpr auto& or_else = detail::static_const<detail::or_else_fn>;
+    }
+LSTM_END
+
+#endif /* LSTM_OR_ELSE_HPP */
@@ -13,13 +13,14 @@ LSTM_DETAIL_BEGIN
                  typename... Args,
                  LSTM_REQUIRES_(!is_void_transact_function<Func&, read_transaction, Args&&...>()),
                  typename Result = transact_result<Func, read_transaction, Args&&...>>
-        static Result slow_path(thread_data& tls_td, Func func, Args&&... args)
+        static Result
+        slow_path(thread_data& tls_td, transaction_domain& domain, Func func, Args&&... args)
         {
+            contention_start<Func>(tls_td, domain);
             while (true) {
-                const epoch_t          version = default_domain().get_clock();
-                const read_transaction tx{version};
-                tls_td.access_lock(version);
-                try {
+                const read_transaction tx{domain, tls_td.access_lock_snapshot(domain)};
+                abort_reason           reason = abort_reason::conflict;
+                LSTM_TRY_ATTEMPT(reason) {
                     LSTM_ASSERT(valid_start_state(tls_td));
 
                     Result result = atomic_base_fn::call(func, tx, (Args &&) args...);
@@ -32,25 +33,25 @@ LSTM_DETAIL_BEGIN
                         return static_cast<Result>(result);
                     else
                         return result;
-                } catch (const tx_retry&) {
-                    // nothing
-                } catch (...) {
+                }
+                LSTM_CATCH_ATTEMPT(reason) {
                     unhandled_exception<tx_kind::read_only>(tls_td);
                 }
-                tx_failure<tx_kind::read_only>(tls_td);
+                tx_failure<tx_kind::read_only>(tls_td, reason, func);
             }
         }
 
         template<typename Func,
                  typename... Args,
                  LSTM_REQUIRES_(is_void_transact_function<Func&, read_transaction, Args&&...>())>
-        static void slow_path(thread_data& tls_td, Func func, Args&&... args)
+        static void
+        slow_path(thread_data& tls_td, transaction_domain& domain, Func func, Args&&... args)
         {
+            contention_start<Func>(tls_td, domain);
             while (true) {
-                const epoch_t          version = default_domain().get_clock();
-                const read_transaction tx{version};
-                tls_td.access_lock(version);
-                try {
+                const read_transaction tx{domain, tls_td.access_lock_snapshot(domain)};
+                abort_reason           reason = abort_reason::conflict;
+                LSTM_TRY_ATTEMPT(reason) {
                     LSTM_ASSERT(valid_start_state(tls_td));
 
                     atomic_base_fn::call(func, tx, (Args &&) args...);
@@ -60,12 +61,11 @@ LSTM_DETAIL_BEGIN
                     LSTM_ASSERT(!tls_td.in_critical_section());
 
                     return;
-                } catch (const tx_retry&) {
-                    // nothing
-                } catch (...) {
+                }
+                LSTM_CATCH_ATTEMPT(reason) {
                     unhandled_exception<tx_kind::read_only>(tls_td);
                 }
-                tx_failure<tx_kind::read_only>(tls_td);
+                tx_failure<tx_kind::read_only>(tls_td, reason, func);
             }
         }
 
@@ -73,24 +73,49 @@ LSTM_DETAIL_BEGIN
         template<typename Func,
                  typename... Args,
                  LSTM_REQUIRES_(is_transact_function<Func&&, read_transaction, Args&&...>())>
-        transact_result<Func, read_transaction, Args&&...>
-        operator()(thread_data& tls_td, Func&& func, Args&&... args) const
+        transact_result<Func, read_transaction, Args&&...> operator()(thread_data&        tls_td,
+                                                                      transaction_domain& domain,
+                                                                      Func&&              func,
+                                                                      Args&&... args) const
         {
+            // nested transactions merge into the rootmost transaction, and so must share its domain
+            LSTM_ASSERT(!tls_td.in_transaction() || &tls_td.domain() == &domain);
             switch (tls_td.tx_kind()) {
             case tx_kind::read_only:
                 return atomic_base_fn::call((Func &&) func,
-                                            read_transaction{tls_td.epoch()},
+                                            read_transaction{domain, tls_td.version()},
                                             (Args &&) args...);
             case tx_kind::read_write:
                 return atomic_base_fn::call((Func &&) func,
-                                            read_transaction{tls_td, tls_td.epoch()},
+                                            read_transaction{tls_td, domain, tls_td.version()},
                                             (Args &&) args...);
             case tx_kind::none:
                 set_read(tls_td);
-                return read_only_fn::slow_path(tls_td, (Func &&) func, (Args &&) args...);
+                return read_only_fn::slow_path(tls_td, domain, (Func &&) func, (Args &&) args...);
             }
         }
 
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(is_transact_function<Func&&, read_transaction, Args&&...>())>
+        transact_result<Func, read_transaction, Args&&...>
+        operator()(thread_data& tls_td, Func&& func, Args&&... args) const
+        {
+            return (*this)(tls_td,
+                           tls_td.in_transaction() ? tls_td.domain() : default_domain(),
+                           (Func &&) func,
+                           (Args &&) args...);
+        }
+
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(is_transact_function<Func&&, read_transaction, Args&&...>())>
+        transact_result<Func, read_transaction, Args&&...>
+        operator()(transaction_domain& domain, Func&& func, Args&&... args) const
+        {
+            return (*this)(tls_thread_data(), domain, (Func &&) func, (Args &&) args...);
+        }
+
         template<typename Func,
                  typename... Args,
                  LSTM_REQUIRES_(is_transact_function<Func&&, read_transaction, Args&&...>())>
@@ -101,6 +126,44 @@ LSTM_DETAIL_BEGIN
         }
 
 #ifndef LSTM_MAKE_SFINAE_FRIENDLY
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(!is_transact_function<Func&&, read_transaction, Args&&...>())>
+        transact_result<Func, read_transaction, Args&&...>
+        operator()(thread_data&, transaction_domain&, Func&&, Args&&...) const
+        {
+            static_assert(is_transact_function_<Func&&, read_transaction, Args&&...>()
+                              && is_transact_function_<uncvref<Func>&,
+                                                       read_transaction,
+                                                       Args&&...>(),
+                          "functions passed to lstm::read_only must either take no parameters, "
+                          "or take a `lstm::read_transaction` either by value or `const&`");
+            static_assert(!is_nothrow_transact_function<Func&&, read_transaction, Args&&...>()
+                              && !is_nothrow_transact_function<uncvref<Func>&,
+                                                               read_transaction,
+                                                               Args&&...>(),
+                          "functions passed to lstm::read_only must not be marked noexcept");
+        }
+
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(!is_transact_function<Func&&, read_transaction, Args&&...>())>
+        transact_result<Func, read_transaction, Args&&...>
+        operator()(transaction_domain&, Func&&, Args&&...) const
+        {
+            static_assert(is_transact_function_<Func&&, read_transaction, Args&&...>()
+                              && is_transact_function_<uncvref<Func>&,
+                                                       read_transaction,
+                                                       Args&&...>(),
+                          "functions passed to lstm::read_only must either take no parameters, "
+                          "or take a `lstm::read_transaction` either by value or `const&`");
+            static_assert(!is_nothrow_transact_function<Func&&, read_transaction, Args&&...>()
+                              && !is_nothrow_transact_function<uncvref<Func>&,
+                                                               read_transaction,
+                                                               Args&&...>(),
+                          "functions passed to lstm::read_only must not be marked noexcept");
+        }
+
         template<typename Func,
                  typename... Args,
                  LSTM_REQUIRES_(!is_transact_function<Func&&, read_transaction, Args&&...>())>
@@ -142,6 +205,8 @@ LSTM_DETAIL_BEGIN
 LSTM_DETAIL_END
 
 LSTM_BEGIN
+    // as with lstm::read_write under LSTM_NO_EXCEPTIONS, the function must not have an automatic
+    // object with a non-trivial destructor alive across a read
     namespace
     {
         constexpr auto& read_only = detail::static_const<detail::read_only_fn>;
@@ -8,14 +8,19 @@ LSTM_BEGIN
     {
         template<typename, typename>
         friend struct ::lstm::var;
+        template<typename, typename>
+        friend struct ::lstm::multi_version_var;
 
-        inline read_transaction(thread_data& in_tls_td, const epoch_t in_version) noexcept
-            : transaction_base(&in_tls_td, in_version)
+        inline read_transaction(thread_data&              in_tls_td,
+                                const transaction_domain& in_domain,
+                                const epoch_t             in_version) noexcept
+            : transaction_base(&in_tls_td, in_domain, in_version)
         {
         }
 
-        explicit inline read_transaction(const epoch_t in_version) noexcept
-            : transaction_base(nullptr, in_version)
+        explicit inline read_transaction(const transaction_domain& in_domain,
+                                         const epoch_t             in_version) noexcept
+            : transaction_base(nullptr, in_domain, in_version)
         {
         }
 
@@ -23,8 +28,28 @@ LSTM_BEGIN
         epoch_t version() const noexcept { return transaction_base::version(); }
 
         bool valid(const thread_data& td) const noexcept { return transaction_base::valid(&td); }
-        bool read_valid(const epoch_t version) const noexcept { return rw_valid(version); }
-        bool read_valid(const detail::var_base& v) const noexcept { return rw_valid(v); }
+        bool read_valid(const epoch_t version) const noexcept
+        {
+            return transaction_base::read_valid(version);
+        }
+        bool read_valid(const detail::var_base& v) const noexcept
+        {
+            return transaction_base::read_valid(v);
+        }
+
+        void release(const detail::var_base& v) const noexcept { ro_release(v); }
+
+        template<typename T, typename Alloc>
+        void release(const var<T, Alloc>& v) const noexcept
+        {
+            v.release(*this);
+        }
+
+        template<typename T, typename Alloc>
+        void release(const multi_version_var<T, Alloc>& v) const noexcept
+        {
+            v.release(*this);
+        }
     };
 LSTM_END
 
@@ -14,13 +14,17 @@ LSTM_DETAIL_BEGIN
                  typename... Args,
                  LSTM_REQUIRES_(!is_void_transact_function<Func&, transaction, Args&&...>()),
                  typename Result = transact_result<Func, transaction, Args&&...>>
-        static Result slow_path(thread_data& tls_td, Func func, Args&&... args)
+        static Result
+        slow_path(thread_data& tls_td, transaction_domain& domain, Func func, Args&&... args)
         {
+            contention_start<Func>(tls_td, domain);
             while (true) {
-                const epoch_t     version = default_domain().get_clock();
-                const transaction tx{tls_td, version};
-                tls_td.access_lock(version);
-                try {
+                irrevocable_start(tls_td, domain);
+                const epoch_t     version = domain.get_clock();
+                const transaction tx{tls_td, domain, version};
+                tls_td.access_lock(domain, version);
+                abort_reason reason = abort_reason::commit;
+                LSTM_TRY_ATTEMPT(reason) {
                     LSTM_ASSERT(valid_start_state(tls_td));
 
                     Result result = atomic_base_fn::call(func, tx, (Args &&) args...);
@@ -37,25 +41,28 @@ LSTM_DETAIL_BEGIN
                         else
                             return result;
                     }
-                } catch (const tx_retry&) {
-                    // nothing
-                } catch (...) {
+                }
+                LSTM_CATCH_ATTEMPT(reason) {
                     unhandled_exception<tx_kind::read_write>(tls_td);
                 }
-                tx_failure<tx_kind::read_write>(tls_td);
+                tx_failure<tx_kind::read_write>(tls_td, reason, func);
             }
         }
 
         template<typename Func,
                  typename... Args,
                  LSTM_REQUIRES_(is_void_transact_function<Func&, transaction, Args&&...>())>
-        static void slow_path(thread_data& tls_td, Func func, Args&&... args)
+        static void
+        slow_path(thread_data& tls_td, transaction_domain& domain, Func func, Args&&... args)
         {
+            contention_start<Func>(tls_td, domain);
             while (true) {
-                const epoch_t     version = default_domain().get_clock();
-                const transaction tx{tls_td, version};
-                tls_td.access_lock(version);
-                try {
+                irrevocable_start(tls_td, domain);
+                const epoch_t     version = domain.get_clock();
+                const transaction tx{tls_td, domain, version};
+                tls_td.access_lock(domain, version);
+                abort_reason reason = abort_reason::commit;
+                LSTM_TRY_ATTEMPT(reason) {
                     LSTM_ASSERT(valid_start_state(tls_td));
 
                     atomic_base_fn::call(func, tx, (Args &&) args...);
@@ -69,12 +76,11 @@ LSTM_DETAIL_BEGIN
 
                         return;
                     }
-                } catch (const tx_retry&) {
-                    // nothing
-                } catch (...) {
+                }
+                LSTM_CATCH_ATTEMPT(reason) {
                     unhandled_exception<tx_kind::read_write>(tls_td);
                 }
-                tx_failure<tx_kind::read_write>(tls_td);
+                tx_failure<tx_kind::read_write>(tls_td, reason, func);
             }
         }
 
@@ -82,17 +88,44 @@ LSTM_DETAIL_BEGIN
         template<typename Func,
                  typename... Args,
                  LSTM_REQUIRES_(is_transact_function<Func&&, transaction, Args&&...>())>
-        transact_result<Func, transaction, Args&&...>
-        operator()(thread_data& tls_td, Func&& func, Args&&... args) const
+        transact_result<Func, transaction, Args&&...> operator()(thread_data&        tls_td,
+                                                                 transaction_domain& domain,
+                                                                 Func&&              func,
+                                                                 Args&&... args) const
         {
             LSTM_ASSERT(!tls_td.in_transaction() || tls_td.in_read_write_transaction());
-            if (tls_td.in_transaction())
+            if (tls_td.in_transaction()) {
+                // nested transactions merge into the rootmost transaction, and so must share its
+                // domain
+                LSTM_ASSERT(&tls_td.domain() == &domain);
                 return atomic_base_fn::call((Func &&) func,
-                                            transaction{tls_td, tls_td.epoch()},
+                                            transaction{tls_td, domain, tls_td.version()},
                                             (Args &&) args...);
+            }
 
             set_rw(tls_td);
-            return read_write_fn::slow_path(tls_td, (Func &&) func, (Args &&) args...);
+            return read_write_fn::slow_path(tls_td, domain, (Func &&) func, (Args &&) args...);
+        }
+
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(is_transact_function<Func&&, transaction, Args&&...>())>
+        transact_result<Func, transaction, Args&&...>
+        operator()(thread_data& tls_td, Func&& func, Args&&... args) const
+        {
+            return (*this)(tls_td,
+                           tls_td.in_transaction() ? tls_td.domain() : default_domain(),
+                           (Func &&) func,
+                           (Args &&) args...);
+        }
+
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(is_transact_function<Func&&, transaction, Args&&...>())>
+        transact_result<Func, transaction, Args&&...>
+        operator()(transaction_domain& domain, Func&& func, Args&&... args) const
+        {
+            return (*this)(tls_thread_data(), domain, (Func &&) func, (Args &&) args...);
         }
 
         template<typename Func,
@@ -104,6 +137,40 @@ LSTM_DETAIL_BEGIN
         }
 
 #ifndef LSTM_MAKE_SFINAE_FRIENDLY
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(!is_transact_function<Func&&, transaction, Args&&...>())>
+        transact_result<Func, transaction, Args&&...>
+        operator()(thread_data&, transaction_domain&, Func&&, Args&&...) const
+        {
+            static_assert(is_transact_function_<Func&&, transaction, Args&&...>()
+                              && is_transact_function_<uncvref<Func>&, transaction, Args&&...>(),
+                          "functions passed to lstm::read_write must either take no parameters, "
+                          "or take a `lstm::transaction` either by value or `const&`");
+            static_assert(!is_nothrow_transact_function<Func&&, transaction, Args&&...>()
+                              && !is_nothrow_transact_function<uncvref<Func>&,
+                                                               transaction,
+                                                               Args&&...>(),
+                          "functions passed to lstm::read_write must not be marked noexcept");
+        }
+
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(!is_transact_function<Func&&, transaction, Args&&...>())>
+        transact_result<Func, transaction, Args&&...>
+        operator()(transaction_domain&, Func&&, Args&&...) const
+        {
+            static_assert(is_transact_function_<Func&&, transaction, Args&&...>()
+                              && is_transact_function_<uncvref<Func>&, transaction, Args&&...>(),
+                          "functions passed to lstm::read_write must either take no parameters, "
+                          "or take a `lstm::transaction` either by value or `const&`");
+            static_assert(!is_nothrow_transact_function<Func&&, transaction, Args&&...>()
+                              && !is_nothrow_transact_function<uncvref<Func>&,
+                                                               transaction,
+                                                               Args&&...>(),
+                          "functions passed to lstm::read_write must not be marked noexcept");
+        }
+
         template<typename Func,
                  typename... Args,
                  LSTM_REQUIRES_(!is_transact_function<Func&&, transaction, Args&&...>())>
@@ -141,6 +208,9 @@ LSTM_DETAIL_BEGIN
 LSTM_DETAIL_END
 
 LSTM_BEGIN
+    // with LSTM_NO_EXCEPTIONS defined, an abort longjmps out of the transaction function instead
+    // of unwinding it. jumping over an automatic object with a non-trivial destructor is undefined
+    // behavior, so the function must not have one alive across a read, a write or lstm::retry
     namespace
     {
         constexpr auto& read_write = detail::static_const<detail::read_write_fn>;
@@ -13,12 +13,15 @@ LSTM_DETAIL_BEGIN
                  typename... Args,
                  LSTM_REQUIRES_(!is_void_transact_function<Func&, critical_section, Args&&...>()),
                  typename Result = transact_result<Func, critical_section, Args&&...>>
-        static Result slow_path(thread_data& tls_td, Func&& func, Args&&... args)
+        static Result
+        slow_path(thread_data& tls_td, transaction_domain& domain, Func&& func, Args&&... args)
         {
             LSTM_ASSERT(!tls_td.in_transaction());
             LSTM_ASSERT(valid_start_state(tls_td));
+#if LSTM_HAS_EXCEPTIONS
             try {
-                tls_td.access_lock(default_domain().get_clock());
+#endif
+                tls_td.access_lock(domain, domain.get_clock());
 
                 Result result
                     = atomic_base_fn::call((Func &&) func, critical_section{}, (Args &&) args...);
@@ -30,44 +33,76 @@ LSTM_DETAIL_BEGIN
                     return static_cast<Result>(result);
                 else
                     return result;
+#if LSTM_HAS_EXCEPTIONS
             } catch (...) {
                 tls_td.access_unlock();
                 LSTM_ASSERT(valid_start_state(tls_td));
                 throw;
             }
+#endif
         }
 
         template<typename Func,
                  typename... Args,
                  LSTM_REQUIRES_(is_void_transact_function<Func&, critical_section, Args&&...>())>
-        static void slow_path(thread_data& tls_td, Func func, Args&&... args)
+        static void
+        slow_path(thread_data& tls_td, transaction_domain& domain, Func func, Args&&... args)
         {
             LSTM_ASSERT(!tls_td.in_transaction());
             LSTM_ASSERT(valid_start_state(tls_td));
+#if LSTM_HAS_EXCEPTIONS
             try {
-                tls_td.access_lock(default_domain().get_clock());
+#endif
+                tls_td.access_lock(domain, domain.get_clock());
 
                 atomic_base_fn::call((Func &&) func, critical_section{}, (Args &&) args...);
 
                 tls_td.access_unlock();
                 LSTM_ASSERT(valid_start_state(tls_td));
+#if LSTM_HAS_EXCEPTIONS
             } catch (...) {
                 tls_td.access_unlock();
                 LSTM_ASSERT(valid_start_state(tls_td));
                 throw;
             }
+#endif
         }
 
     public:
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(is_transact_function<Func&&, critical_section, Args&&...>())>
+        transact_result<Func, critical_section, Args&&...> operator()(thread_data&        tls_td,
+                                                                      transaction_domain& domain,
+                                                                      Func&&              func,
+                                                                      Args&&... args) const
+        {
+            if (tls_td.in_critical_section()) {
+                LSTM_ASSERT(&tls_td.domain() == &domain);
+                return atomic_base_fn::call((Func &&) func, critical_section{}, (Args &&) args...);
+            }
+            return relative_fn::slow_path(tls_td, domain, (Func &&) func, (Args &&) args...);
+        }
+
         template<typename Func,
                  typename... Args,
                  LSTM_REQUIRES_(is_transact_function<Func&&, critical_section, Args&&...>())>
         transact_result<Func, critical_section, Args&&...>
         operator()(thread_data& tls_td, Func&& func, Args&&... args) const
         {
-            if (tls_td.in_critical_section())
-                return atomic_base_fn::call((Func &&) func, critical_section{}, (Args &&) args...);
-            return relative_fn::slow_path(tls_td, (Func &&) func, (Args &&) args...);
+            return (*this)(tls_td,
+                           tls_td.in_critical_section() ? tls_td.domain() : default_domain(),
+                           (Func &&) func,
+                           (Args &&) args...);
+        }
+
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(is_transact_function<Func&&, critical_section, Args&&...>())>
+        transact_result<Func, critical_section, Args&&...>
+        operator()(transaction_domain& domain, Func&& func, Args&&... args) const
+        {
+            return (*this)(tls_thread_data(), domain, (Func &&) func, (Args &&) args...);
         }
 
         template<typename Func,
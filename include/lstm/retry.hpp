@@ -2,12 +2,20 @@
 #define LSTM_RETRY_HPP
 
 #include <lstm/detail/backoff.hpp>
+#include <lstm/detail/restart.hpp>
 
 LSTM_BEGIN
+    // fails the current attempt at a transaction. read write transactions then block until another
+    // commit writes to one of the vars they read, so waiting on a condition does not spin. attempts
+    // that read nothing, and read only transactions, back off as after any other failure
     [[noreturn]] LSTM_NOINLINE_LUKEWARM inline void retry()
     {
         LSTM_PERF_STATS_USER_FAILURES();
-        throw detail::tx_retry{};
+#ifndef LSTM_NO_EXCEPTIONS
+        throw detail::tx_retry{abort_reason::retry};
+#else
+        detail::restart(abort_reason::retry);
+#endif
     }
 LSTM_END
 
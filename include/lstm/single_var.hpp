@@ -0,0 +1,181 @@
+#ifndef LSTM_SINGLE_VAR_HPP
+#define LSTM_SINGLE_VAR_HPP
+
+#include <lstm/read_write.hpp>
+#include <lstm/var.hpp>
+
+LSTM_DETAIL_BEGIN
+    // outside of a transaction, an atomic var is updated with no read or write set. its value is
+    // loaded along with the version it was written at, and the update commits by locking only that
+    // var, from that version. anything in the way falls back to a full transaction.
+    // a var does not know its domain, so every update names it. it must be the domain the var's
+    // transactions run in, as the var is locked and versioned against that domain's clock
+    struct single_var_fn
+    {
+    protected:
+        // not deduced, so that the value need not be of the same type as the var
+        template<typename T, typename Alloc>
+        using value_type = typename var<T, Alloc>::value_type;
+
+        template<typename T, typename Alloc>
+        static T load(const var<T, Alloc>& v) noexcept
+        {
+            return var<T, Alloc>::load(v.storage.load(LSTM_ACQUIRE));
+        }
+
+        template<typename T, typename Alloc>
+        static epoch_t version(const transaction_domain& domain, const var<T, Alloc>& v) noexcept
+        {
+            return commit_algorithm::single_var_version(domain, v);
+        }
+
+        template<typename T, typename Alloc>
+        static bool valid(const transaction_domain& domain,
+                          const var<T, Alloc>&      v,
+                          const epoch_t             version) noexcept
+        {
+            return commit_algorithm::single_var_valid(domain, v, version);
+        }
+
+        template<typename T, typename Alloc, typename U>
+        static bool try_commit(transaction_domain& domain,
+                               var<T, Alloc>&      v,
+                               U&&                 u,
+                               const epoch_t       version) noexcept
+        {
+            return commit_algorithm::try_single_var_commit(domain,
+                                                           v,
+                                                           v.allocate_construct((U &&) u),
+                                                           version);
+        }
+    };
+
+    struct atomic_update_fn : private single_var_fn
+    {
+    private:
+        template<typename T, typename Alloc, typename Func>
+        LSTM_NOINLINE static T slow_path(thread_data&        tls_td,
+                                         transaction_domain& domain,
+                                         var<T, Alloc>&      v,
+                                         Func&               func)
+        {
+            return ::lstm::read_write(tls_td, domain, [&](const transaction tx) {
+                T result = v.get(tx);
+                v.set(tx, func(static_cast<const T&>(result)));
+                return result;
+            });
+        }
+
+    public:
+        // stores func(value) to v, and returns the value it replaced. func may be called more than
+        // once, so must not touch anything but its argument
+        template<typename T,
+                 typename Alloc,
+                 typename Func,
+                 LSTM_REQUIRES_(var<T, Alloc>::atomic
+                                && std::is_constructible<T, decltype(std::declval<Func&>()(
+                                                                std::declval<const T&>()))>())>
+        T operator()(transaction_domain& domain, var<T, Alloc>& v, Func&& func) const
+        {
+            thread_data& tls_td = tls_thread_data();
+            if (LSTM_LIKELY(!tls_td.in_transaction())) {
+                const epoch_t version = single_var_fn::version(domain, v);
+                const T       result  = single_var_fn::load(v);
+                if (LSTM_LIKELY(single_var_fn::try_commit(domain, v, func(result), version)))
+                    return result;
+            }
+            return atomic_update_fn::slow_path(tls_td, domain, v, func);
+        }
+
+        template<typename T,
+                 typename Alloc,
+                 typename Func,
+                 LSTM_REQUIRES_(!var<T, Alloc>::atomic
+                                && std::is_constructible<T, decltype(std::declval<Func&>()(
+                                                                std::declval<const T&>()))>())>
+        T operator()(transaction_domain& domain, var<T, Alloc>& v, Func&& func) const
+        {
+            return atomic_update_fn::slow_path(tls_thread_data(), domain, v, func);
+        }
+    };
+
+    struct exchange_fn : private single_var_fn
+    {
+        // stores value to v, and returns the value it replaced
+        template<typename T, typename Alloc>
+        T operator()(transaction_domain&         domain,
+                     var<T, Alloc>&              v,
+                     const value_type<T, Alloc>& value) const
+        {
+            return static_const<atomic_update_fn>(domain, v, [&](const T&) -> const T& {
+                return value;
+            });
+        }
+    };
+
+    struct compare_exchange_fn : private single_var_fn
+    {
+    private:
+        template<typename T, typename Alloc>
+        LSTM_NOINLINE static bool slow_path(thread_data&        tls_td,
+                                            transaction_domain& domain,
+                                            var<T, Alloc>&      v,
+                                            T&                  expected,
+                                            const T&            desired)
+        {
+            return ::lstm::read_write(tls_td, domain, [&](const transaction tx) {
+                const T& value = v.get(tx);
+                if (value == expected) {
+                    v.set(tx, desired);
+                    return true;
+                }
+                expected = value;
+                return false;
+            });
+        }
+
+    public:
+        // stores desired to v if v holds expected. otherwise, loads the value of v into expected.
+        // a failed compare_exchange writes nothing, so needs no lock
+        template<typename T, typename Alloc, LSTM_REQUIRES_(var<T, Alloc>::atomic)>
+        bool operator()(transaction_domain&         domain,
+                        var<T, Alloc>&              v,
+                        T&                          expected,
+                        const value_type<T, Alloc>& desired) const
+        {
+            thread_data& tls_td = tls_thread_data();
+            if (LSTM_LIKELY(!tls_td.in_transaction())) {
+                const epoch_t version = single_var_fn::version(domain, v);
+                const T       value   = single_var_fn::load(v);
+                if (value == expected) {
+                    if (LSTM_LIKELY(single_var_fn::try_commit(domain, v, desired, version)))
+                        return true;
+                } else if (LSTM_LIKELY(single_var_fn::valid(domain, v, version))) {
+                    expected = value;
+                    return false;
+                }
+            }
+            return compare_exchange_fn::slow_path(tls_td, domain, v, expected, desired);
+        }
+
+        template<typename T, typename Alloc, LSTM_REQUIRES_(!var<T, Alloc>::atomic)>
+        bool operator()(transaction_domain&         domain,
+                        var<T, Alloc>&              v,
+                        T&                          expected,
+                        const value_type<T, Alloc>& desired) const
+        {
+            return compare_exchange_fn::slow_path(tls_thread_data(), domain, v, expected, desired);
+        }
+    };
+LSTM_DETAIL_END
+
+LSTM_BEGIN
+    namespace
+    {
+        constexpr auto& atomic_update    = detail::static_const<detail::atomic_update_fn>;
+        constexpr auto& exchange         = detail::static_const<detail::exchange_fn>;
+        constexpr auto& compare_exchange = detail::static_const<detail::compare_exchange_fn>;
+    }
+LSTM_END
+
+#endif /* LSTM_SINGLE_VAR_HPP */
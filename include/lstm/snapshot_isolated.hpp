@@ -0,0 +1,136 @@
+#ifndef LSTM_SNAPSHOT_ISOLATED_HPP
+#define LSTM_SNAPSHOT_ISOLATED_HPP
+
+#include <lstm/read_write.hpp>
+
+LSTM_DETAIL_BEGIN
+    // snapshot isolated transactions read from a single snapshot, but keep no read set. only the
+    // write set is validated at commit, so the first committer wins, and write skew is possible
+    struct snapshot_isolated_fn : private detail::atomic_base_fn
+    {
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(is_transact_function<Func&&, transaction, Args&&...>())>
+        transact_result<Func, transaction, Args&&...> operator()(thread_data&        tls_td,
+                                                                 transaction_domain& domain,
+                                                                 Func&&              func,
+                                                                 Args&&... args) const
+        {
+            // nested transactions merge into the rootmost transaction, and keep its isolation
+            if (!tls_td.in_transaction())
+                set_snapshot_isolated(tls_td);
+            return ::lstm::read_write(tls_td, domain, (Func &&) func, (Args &&) args...);
+        }
+
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(is_transact_function<Func&&, transaction, Args&&...>())>
+        transact_result<Func, transaction, Args&&...>
+        operator()(thread_data& tls_td, Func&& func, Args&&... args) const
+        {
+            return (*this)(tls_td,
+                           tls_td.in_transaction() ? tls_td.domain() : default_domain(),
+                           (Func &&) func,
+                           (Args &&) args...);
+        }
+
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(is_transact_function<Func&&, transaction, Args&&...>())>
+        transact_result<Func, transaction, Args&&...>
+        operator()(transaction_domain& domain, Func&& func, Args&&... args) const
+        {
+            return (*this)(tls_thread_data(), domain, (Func &&) func, (Args &&) args...);
+        }
+
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(is_transact_function<Func&&, transaction, Args&&...>())>
+        transact_result<Func, transaction, Args&&...> operator()(Func&& func, Args&&... args) const
+        {
+            return (*this)(tls_thread_data(), (Func &&) func, (Args &&) args...);
+        }
+
+#ifndef LSTM_MAKE_SFINAE_FRIENDLY
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(!is_transact_function<Func&&, transaction, Args&&...>())>
+        transact_result<Func, transaction, Args&&...>
+        operator()(thread_data&, transaction_domain&, Func&&, Args&&...) const
+        {
+            static_assert(is_transact_function_<Func&&, transaction, Args&&...>()
+                              && is_transact_function_<uncvref<Func>&, transaction, Args&&...>(),
+                          "functions passed to lstm::snapshot_isolated must either take no "
+                          "parameters, or take a `lstm::transaction` either by value or `const&`");
+            static_assert(!is_nothrow_transact_function<Func&&, transaction, Args&&...>()
+                              && !is_nothrow_transact_function<uncvref<Func>&,
+                                                               transaction,
+                                                               Args&&...>(),
+                          "functions passed to lstm::snapshot_isolated must not be marked "
+                          "noexcept");
+        }
+
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(!is_transact_function<Func&&, transaction, Args&&...>())>
+        transact_result<Func, transaction, Args&&...>
+        operator()(transaction_domain&, Func&&, Args&&...) const
+        {
+            static_assert(is_transact_function_<Func&&, transaction, Args&&...>()
+                              && is_transact_function_<uncvref<Func>&, transaction, Args&&...>(),
+                          "functions passed to lstm::snapshot_isolated must either take no "
+                          "parameters, or take a `lstm::transaction` either by value or `const&`");
+            static_assert(!is_nothrow_transact_function<Func&&, transaction, Args&&...>()
+                              && !is_nothrow_transact_function<uncvref<Func>&,
+                                                               transaction,
+                                                               Args&&...>(),
+                          "functions passed to lstm::snapshot_isolated must not be marked "
+                          "noexcept");
+        }
+
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(!is_transact_function<Func&&, transaction, Args&&...>())>
+        transact_result<Func, transaction, Args&&...>
+        operator()(thread_data&, Func&&, Args&&...) const
+        {
+            static_assert(is_transact_function_<Func&&, transaction, Args&&...>()
+                              && is_transact_function_<uncvref<Func>&, transaction, Args&&...>(),
+                          "functions passed to lstm::snapshot_isolated must either take no "
+                          "parameters, or take a `lstm::transaction` either by value or `const&`");
+            static_assert(!is_nothrow_transact_function<Func&&, transaction, Args&&...>()
+                              && !is_nothrow_transact_function<uncvref<Func>&,
+                                                               transaction,
+                                                               Args&&...>(),
+                          "functions passed to lstm::snapshot_isolated must not be marked "
+                          "noexcept");
+        }
+
+        template<typename Func,
+                 typename... Args,
+                 LSTM_REQUIRES_(!is_transact_function<Func&&, transaction, Args&&...>())>
+        transact_result<Func, transaction, Args&&...> operator()(Func&&, Args&&...) const
+        {
+            static_assert(is_transact_function_<Func&&, transaction, Args&&...>()
+                              && is_transact_function_<uncvref<Func>&, transaction, Args&&...>(),
+                          "functions passed to lstm::snapshot_isolated must either take no "
+                          "parameters, or take a `lstm::transaction` either by value or `const&`");
+            static_assert(!is_nothrow_transact_function<Func&&, transaction, Args&&...>()
+                              && !is_nothrow_transact_function<uncvref<Func>&,
+                                                               transaction,
+                                                               Args&&...>(),
+                          "functions passed to lstm::snapshot_isolated must not be marked "
+                          "noexcept");
+        }
+#endif /* LSTM_MAKE_SFINAE_FRIENDLY */
+    };
+LSTM_DETAIL_END
+
+LSTM_BEGIN
+    namespace
+    {
+        constexpr auto& snapshot_isolated = detail::static_const<detail::snapshot_isolated_fn>;
+    }
+LSTM_END
+
+#endif /* LSTM_SNAPSHOT_ISOLATED_HPP */
@@ -1,13 +1,17 @@
 #ifndef LSTM_THREAD_DATA_HPP
 #define LSTM_THREAD_DATA_HPP
 
+#include <lstm/detail/deferred_value_type.hpp>
 #include <lstm/detail/pod_hash_set.hpp>
 #include <lstm/detail/quiescence_buffer.hpp>
 #include <lstm/detail/read_set_value_type.hpp>
 #include <lstm/detail/thread_synchronization.hpp>
+#include <lstm/detail/undo_log_value_type.hpp>
 #include <lstm/detail/var_detail.hpp>
 #include <lstm/detail/write_set_value_type.hpp>
 
+#include <lstm/transaction_domain.hpp>
+
 #ifdef LSTM_USE_BOOST_FIBERS
 #include <boost/fiber/fss.hpp>
 #endif
@@ -26,13 +30,17 @@ LSTM_BEGIN
         friend detail::atomic_base_fn;
         friend detail::commit_algorithm;
         friend detail::transaction_base;
+        friend detail::retry_waiters;
 
         using read_set_t  = detail::pod_vector<detail::read_set_value_type>;
         using write_set_t = detail::pod_hash_set<detail::pod_vector<detail::write_set_value_type>>;
         using callbacks_t = detail::pod_vector<detail::gp_callback>;
+        using undo_log_t  = detail::pod_vector<detail::undo_log_value_type>;
+        using deferred_log_t      = detail::pod_vector<detail::deferred_value_type>;
         using read_set_const_iter = typename read_set_t::const_iterator;
         using write_set_iter      = typename write_set_t::iterator;
         using callbacks_iter      = typename callbacks_t::iterator;
+        using deferred_iter       = typename deferred_log_t::iterator;
 
         // TODO: optimize this layout
         struct _cache_line_offset_calculation
@@ -57,6 +65,55 @@ LSTM_BEGIN
         detail::quiescence_buffer<>                                            succ_callbacks;
         tx_kind                                                                tx_state;
         detail::thread_synchronization_node<synchronization_cache_line_offset> synchronization_node;
+        epoch_t                                                                tx_version;
+        // under encounter time locking, the version_lock of vars this thread owns. 0 otherwise
+        epoch_t                                                                tx_owner_lock;
+        undo_log_t                                                             undo_log;
+        // set once the transaction reads a var that is never revalidated, either untracked, or
+        // through a demoted transaction. the snapshot can then no longer be extended
+        bool                                                                   tx_unvalidated_reads;
+        // set when the write set holds a multi_version_var. the commit must then write to the clock
+        bool                                                                   tx_ordered_commit;
+        // set for the whole of a snapshot isolated transaction, retries included. reads are then
+        // never recorded, and only the write set is validated at commit
+        bool                                                                   tx_snapshot_isolated;
+        // set for an attempt that holds the domain's irrevocable token. every var is then valid,
+        // and vars are written in place as under encounter time locking
+        bool                                                                   tx_irrevocable;
+        // under commit_mode::combining, links the commits posted to the domain. the combiner stores
+        // the sync epoch to commit_result once this thread's writes are published
+        thread_data*                                                           next_commit_request;
+        std::atomic<epoch_t>                                                   commit_result;
+        // the contention manager of the current transaction, and what it knows about its failures
+        const detail::contention_policy*                                       tx_contention_policy;
+        contention_info                                                        tx_contention;
+        // the number of or_else alternatives being run. storage that a savepoint must be able to
+        // restore is replaced instead of written in place, and logged here
+        uword                                                                  tx_savepoints;
+        undo_log_t                                                             savepoint_log;
+        // commutative updates to vars outside of the write set, applied as the commit locks them.
+        // their hashes are kept in the filter of the write set, so that reads of the vars take the
+        // slow path. an update whose var has since been written is dropped at commit
+        deferred_log_t                                                         deferred_log;
+        // run, oldest first, as soon as the transaction commits. nothing it replaced is reclaimed
+        // until they return
+        callbacks_t                                                            commit_callbacks;
+        // set on the thread_data that lstm::open_nested runs transactions on, to the thread_data
+        // of the transactions they are nested in
+        thread_data*                                                           open_nested_parent;
+        // the read set of a failed attempt blocked in lstm::retry, when its hash is too saturated
+        // to tell the commits that wake it from the ones that do not. empty otherwise
+        read_set_t                                                             retry_read_set;
+        // the domains destroyed while succ_callbacks held epochs of theirs
+        detail::domain_retirement                                              retirement;
+#ifdef LSTM_READ_SET_CACHE
+        static_assert(LSTM_READ_SET_CACHE > 0
+                          && (LSTM_READ_SET_CACHE & (LSTM_READ_SET_CACHE - 1)) == 0,
+                      "LSTM_READ_SET_CACHE must be a power of two");
+        // the positions in read_set of recently read vars, by address. a position is only trusted
+        // if read_set still holds the var there, so clearing the read set leaves the cache alone
+        uword read_set_cache[LSTM_READ_SET_CACHE];
+#endif
 
         void add_write_set_unchecked(detail::var_base&         dest_var,
                                      const detail::var_storage pending_write,
@@ -82,10 +139,49 @@ LSTM_BEGIN
             write_set.push_back(&dest_var, pending_write, hash);
         }
 
+        // whether src_var is known to already be in the read set. if not, src_var is cached at the
+        // position it is about to be pushed to
+        bool in_read_set_cache(const detail::var_base& src_var) noexcept
+        {
+#ifdef LSTM_READ_SET_CACHE
+            constexpr detail::hash_t shift = detail::calcShift<detail::var_base>();
+            const detail::hash_t     mixed
+                = (reinterpret_cast<std::uintptr_t>(&src_var) >> shift) * 0x9E3779B97F4A7C15ull;
+            uword& position = read_set_cache[(mixed >> 32) & (LSTM_READ_SET_CACHE - 1)];
+            if (position < read_set.size() && read_set.begin()[position].is_src_var(src_var)) {
+                LSTM_PERF_STATS_DUPLICATE_READS();
+                return true;
+            }
+            position = read_set.size();
+#else
+            (void)src_var;
+#endif
+            return false;
+        }
+
+        deferred_iter find_deferred(const detail::var_base& dest_var) noexcept
+        {
+            const deferred_iter end = deferred_log.end();
+            for (deferred_iter iter = deferred_log.begin(); iter != end; ++iter) {
+                if (iter->is_dest_var(dest_var))
+                    return iter;
+            }
+            return end;
+        }
+
+        // records where the attempt in progress is failing, for its contention manager
+        void set_abort_cause(const abort_cause cause, const detail::var_base* const var) noexcept
+        {
+            tx_contention.cause = cause;
+            tx_contention.var   = var;
+        }
+
         void clear_read_write_sets() noexcept
         {
             read_set.clear();
             write_set.clear();
+            savepoint_log.clear();
+            deferred_log.clear();
         }
 
         void do_succ_callbacks_front() noexcept
@@ -96,12 +192,13 @@ LSTM_BEGIN
             succ_callbacks.do_first_epoch_callbacks();
         }
 
-        void do_fail_callbacks() noexcept
+        // runs, newest first, and drops the callbacks from index first_callback on
+        void do_fail_callbacks(const uword first_callback = 0) noexcept
         {
 #ifndef NDEBUG
             const std::size_t fail_start_size = fail_callbacks.size();
 #endif
-            const callbacks_iter begin = fail_callbacks.begin();
+            const callbacks_iter begin = fail_callbacks.begin() + first_callback;
             for (callbacks_iter riter = fail_callbacks.end(); riter != begin;)
                 (*--riter)();
 
@@ -109,7 +206,26 @@ LSTM_BEGIN
             LSTM_ASSERT(fail_start_size == fail_callbacks.size());
 #endif
 
-            fail_callbacks.clear();
+            fail_callbacks.truncate(first_callback);
+        }
+
+        // runs, oldest first, and drops the callbacks of a committed transaction. they must not
+        // run transactions of their own
+        void do_commit_callbacks() noexcept
+        {
+            LSTM_ASSERT(!in_transaction());
+#ifndef NDEBUG
+            const std::size_t commit_start_size = commit_callbacks.size();
+#endif
+            const callbacks_iter end = commit_callbacks.end();
+            for (callbacks_iter iter = commit_callbacks.begin(); iter != end; ++iter)
+                (*iter)();
+
+#ifndef NDEBUG
+            LSTM_ASSERT(commit_start_size == commit_callbacks.size());
+#endif
+
+            commit_callbacks.clear();
         }
 
         void reclaim_all() noexcept
@@ -118,13 +234,15 @@ LSTM_BEGIN
             LSTM_ASSERT(!in_critical_section());
             LSTM_ASSERT(!succ_callbacks.empty());
 
-            synchronize_min_epoch(succ_callbacks.back_epoch());
             do {
-                do_succ_callbacks_front();
+                reclaim_slow_path();
             } while (!succ_callbacks.empty());
         }
 
-        LSTM_ALWAYS_INLINE void reclaim_all_possible(const epoch_t min_epoch) noexcept
+        // epochs from different domains are unordered, so reclamation stops at the first epoch
+        // that belongs to another domain
+        LSTM_ALWAYS_INLINE void reclaim_all_possible(const transaction_domain* const domain,
+                                                     const epoch_t min_epoch) noexcept
         {
             LSTM_ASSERT(!in_transaction());
             LSTM_ASSERT(!in_critical_section());
@@ -132,25 +250,84 @@ LSTM_BEGIN
 
             do {
                 do_succ_callbacks_front();
-            } while (!succ_callbacks.empty() && succ_callbacks.front_epoch() < min_epoch);
+            } while (!succ_callbacks.empty() && succ_callbacks.front_domain() == domain
+                     && succ_callbacks.front_epoch() < min_epoch);
+
+            if (succ_callbacks.empty())
+                retirement.set_queued(false);
         }
 
+        // epochs of destroyed domains are forgotten before any other epoch is stamped with the
+        // address of a domain, which may since have been reused
+        LSTM_NOINLINE_LUKEWARM void forget_retired_domains() noexcept
+        {
+            retirement.forget_retired(
+                [&](const transaction_domain& domain) { succ_callbacks.forget_domain(domain); });
+        }
+
+        // the transaction an open nested transaction is nested in stays in its critical section
+        // until the open nested one returns. if reclaiming the oldest epoch would wait on it,
+        // reclamation is put off to a later commit
+        bool waits_on_open_nested_parent() const noexcept
+        {
+            const transaction_domain* const domain = succ_callbacks.front_domain();
+            return open_nested_parent && domain
+                   && open_nested_parent->synchronization_node
+                          .epoch_less_equal_to(*domain, succ_callbacks.front_epoch());
+        }
+
+        // the domain of the oldest epoch is only used while holding the retirement lock, so that it
+        // cannot be destroyed underneath. the callbacks themselves run without it, as they may
+        // destroy domains
         LSTM_NOINLINE_LUKEWARM void reclaim_slow_path() noexcept
         {
             LSTM_ASSERT(!in_transaction());
             LSTM_ASSERT(!in_critical_section());
 
-            const epoch_t min_epoch = synchronize_min_epoch(succ_callbacks.front_epoch());
-            reclaim_all_possible(min_epoch);
+            detail::domain_retirement::lock_shared();
+            while (LSTM_UNLIKELY(retirement.retired_any())) {
+                detail::domain_retirement::unlock_shared();
+                forget_retired_domains();
+                detail::domain_retirement::lock_shared();
+            }
+
+            transaction_domain* const domain      = succ_callbacks.front_domain();
+            const epoch_t             front_epoch = succ_callbacks.front_epoch();
+            const epoch_t             min_epoch
+                = domain ? synchronize_min_epoch(*domain, front_epoch) : detail::off_state;
+            detail::domain_retirement::unlock_shared();
+
+            reclaim_all_possible(domain, min_epoch);
         }
 
     public:
         LSTM_NOINLINE thread_data() noexcept
             : tx_state(tx_kind::none)
+            , tx_version(detail::off_state)
+            , tx_owner_lock(0)
+            , tx_unvalidated_reads(false)
+            , tx_ordered_commit(false)
+            , tx_snapshot_isolated(false)
+            , tx_irrevocable(false)
+            , next_commit_request(nullptr)
+            , commit_result(detail::off_state)
+            , tx_contention_policy(nullptr)
+            , tx_contention{}
+            , tx_savepoints(0)
+            , open_nested_parent(nullptr)
+#ifdef LSTM_READ_SET_CACHE
+            , read_set_cache{}
+#endif
         {
             LSTM_ASSERT(std::uintptr_t(this) % LSTM_CACHE_LINE_SIZE == 0);
         }
 
+        LSTM_NOINLINE explicit thread_data(thread_data& in_open_nested_parent) noexcept
+            : thread_data()
+        {
+            open_nested_parent = &in_open_nested_parent;
+        }
+
         thread_data(const thread_data&) = delete;
         thread_data& operator=(const thread_data&) = delete;
 
@@ -159,8 +336,13 @@ LSTM_BEGIN
             LSTM_ASSERT(!in_critical_section());
             LSTM_ASSERT(!in_transaction());
             LSTM_ASSERT(read_set.empty());
+            LSTM_ASSERT(retry_read_set.empty());
             LSTM_ASSERT(write_set.empty());
+            LSTM_ASSERT(undo_log.empty());
+            LSTM_ASSERT(savepoint_log.empty());
+            LSTM_ASSERT(deferred_log.empty());
             LSTM_ASSERT(fail_callbacks.empty());
+            LSTM_ASSERT(commit_callbacks.empty());
             LSTM_ASSERT(succ_callbacks.working_epoch_empty());
 
             if (!succ_callbacks.empty())
@@ -191,9 +373,53 @@ LSTM_BEGIN
 
         LSTM_ALWAYS_INLINE epoch_t epoch() const noexcept { return synchronization_node.epoch(); }
 
+        // the version reads are validated against. starts out equal to epoch(), but read write
+        // transactions may extend their snapshot past it
+        LSTM_ALWAYS_INLINE epoch_t version() const noexcept { return tx_version; }
+
+        LSTM_ALWAYS_INLINE bool encounter_time_locking() const noexcept { return tx_owner_lock; }
+
+        LSTM_ALWAYS_INLINE bool snapshot_isolated() const noexcept { return tx_snapshot_isolated; }
+
+        LSTM_ALWAYS_INLINE bool irrevocable() const noexcept { return tx_irrevocable; }
+
+        // only meaningful while in a critical section, or immediately after leaving one
+        LSTM_ALWAYS_INLINE transaction_domain& domain() const noexcept
+        {
+            LSTM_ASSERT(synchronization_node.domain());
+            return *synchronization_node.domain();
+        }
+
+        LSTM_ALWAYS_INLINE void access_lock(transaction_domain& domain,
+                                            const epoch_t       epoch) noexcept
+        {
+            synchronization_node.access_lock(domain, epoch);
+            tx_version           = epoch;
+            tx_owner_lock        = domain.get_locking_mode() == locking_mode::encounter_time
+                                       ? detail::as_locked(reinterpret_cast<std::uintptr_t>(this))
+                                       : 0;
+            tx_unvalidated_reads = tx_snapshot_isolated;
+            tx_ordered_commit    = false;
+            if (LSTM_UNLIKELY(tx_irrevocable)) {
+                tx_version    = transaction_domain::max_version();
+                tx_owner_lock = detail::as_locked(reinterpret_cast<std::uintptr_t>(this));
+            }
+        }
+
         LSTM_ALWAYS_INLINE void access_lock(const epoch_t epoch) noexcept
         {
-            synchronization_node.access_lock(epoch);
+            access_lock(default_domain(), epoch);
+        }
+
+        // read only transactions take their version after publishing their epoch. every commit that
+        // writes to the clock, and publishes past that version, then waits on this thread before
+        // reclaiming what it replaced. multi_version_var relies on this to read those values
+        LSTM_ALWAYS_INLINE epoch_t access_lock_snapshot(transaction_domain& domain) noexcept
+        {
+            access_lock(domain, domain.get_clock());
+            std::atomic_thread_fence(LSTM_SEQ_CST);
+            tx_version = domain.get_clock();
+            return tx_version;
         }
 
         LSTM_ALWAYS_INLINE void access_relock(const epoch_t epoch) noexcept
@@ -203,15 +429,29 @@ LSTM_BEGIN
 
         LSTM_ALWAYS_INLINE void access_unlock() noexcept { synchronization_node.access_unlock(); }
 
+        LSTM_ALWAYS_INLINE bool epoch_less_equal_to(const transaction_domain& domain,
+                                                    const epoch_t             epoch) const noexcept
+        {
+            return synchronization_node.epoch_less_equal_to(domain, epoch);
+        }
+
         LSTM_ALWAYS_INLINE bool epoch_less_equal_to(const epoch_t epoch) const noexcept
         {
-            return synchronization_node.epoch_less_equal_to(epoch);
+            return epoch_less_equal_to(default_domain(), epoch);
         }
 
-        LSTM_ALWAYS_INLINE epoch_t synchronize_min_epoch(const epoch_t sync_epoch) const noexcept
+        LSTM_ALWAYS_INLINE epoch_t synchronize_min_epoch(transaction_domain& domain,
+                                                         const epoch_t sync_epoch) const noexcept
         {
             LSTM_ASSERT(!in_transaction());
-            return synchronization_node.synchronize_min_epoch(sync_epoch);
+            // lazy clocks might not have moved past sync_epoch yet
+            domain.advance_past(sync_epoch);
+            return synchronization_node.synchronize_min_epoch(domain, sync_epoch);
+        }
+
+        LSTM_ALWAYS_INLINE epoch_t synchronize_min_epoch(const epoch_t sync_epoch) const noexcept
+        {
+            return synchronize_min_epoch(default_domain(), sync_epoch);
         }
 
         template<typename Func,
@@ -231,6 +471,15 @@ LSTM_BEGIN
             fail_callbacks.emplace_back((Func &&) func);
         }
 
+        template<typename Func,
+                 LSTM_REQUIRES_(std::is_constructible<detail::gp_callback, Func&&>{})>
+        void after_commit(Func&& func) noexcept(
+            noexcept(commit_callbacks.emplace_back((Func &&) func)))
+        {
+            LSTM_ASSERT(in_transaction());
+            commit_callbacks.emplace_back((Func &&) func);
+        }
+
         void reclaim(const epoch_t sync_epoch) noexcept
         {
             LSTM_ASSERT(!in_critical_section());
@@ -238,21 +487,37 @@ LSTM_BEGIN
             LSTM_ASSERT(sync_epoch != detail::off_state);
             LSTM_ASSERT(!detail::locked(sync_epoch));
 
-            if (LSTM_UNLIKELY(succ_callbacks.finalize_epoch(sync_epoch)))
+            if (succ_callbacks.working_epoch_empty())
+                return;
+
+            if (LSTM_UNLIKELY(retirement.retired_any()))
+                forget_retired_domains();
+            retirement.set_queued(true);
+
+            if (LSTM_UNLIKELY(succ_callbacks.finalize_epoch(domain(), sync_epoch))
+                && LSTM_LIKELY(!waits_on_open_nested_parent()))
                 reclaim_slow_path();
         }
 
         // clears up all buffers that greedily hold on to extra storage
         void shrink_to_fit() noexcept(noexcept(read_set.shrink_to_fit(),
                                                write_set.shrink_to_fit(),
+                                               undo_log.shrink_to_fit(),
+                                               savepoint_log.shrink_to_fit(),
+                                               deferred_log.shrink_to_fit(),
                                                fail_callbacks.shrink_to_fit(),
+                                               commit_callbacks.shrink_to_fit(),
                                                succ_callbacks.shrink_to_fit()))
         {
             if (!in_critical_section() && !succ_callbacks.empty())
                 reclaim_all();
             read_set.shrink_to_fit();
             write_set.shrink_to_fit();
+            undo_log.shrink_to_fit();
+            savepoint_log.shrink_to_fit();
+            deferred_log.shrink_to_fit();
             fail_callbacks.shrink_to_fit();
+            commit_callbacks.shrink_to_fit();
             succ_callbacks.shrink_to_fit();
         }
     };
@@ -8,28 +8,36 @@ LSTM_BEGIN
     {
         template<typename, typename>
         friend struct ::lstm::var;
+        template<typename, typename>
+        friend struct ::lstm::multi_version_var;
 
-        inline transaction(thread_data& in_tls_td, const epoch_t in_version) noexcept
-            : transaction_base(&in_tls_td, in_version)
+        inline transaction(thread_data&              in_tls_td,
+                           const transaction_domain& in_domain,
+                           const epoch_t             in_version) noexcept
+            : transaction_base(&in_tls_td, in_domain, in_version)
         {
         }
 
         explicit operator read_transaction() const noexcept
         {
-            return {get_thread_data(), version()};
+            return {get_thread_data(), domain(), version()};
         }
 
         read_transaction unsafe_unchecked_demote() const noexcept
         {
             LSTM_ASSERT(can_demote_safely());
-            return read_transaction{version()};
+            // reads through the demoted transaction are never revalidated
+            disable_extension();
+            return read_transaction{domain(), version()};
         }
 
         read_transaction unsafe_checked_demote() const noexcept
         {
-            if (can_demote_safely())
-                return read_transaction{version()};
-            return read_transaction{get_thread_data(), version()};
+            if (can_demote_safely()) {
+                disable_extension();
+                return read_transaction{domain(), version()};
+            }
+            return read_transaction{get_thread_data(), domain(), version()};
         }
 
         thread_data& get_thread_data() const noexcept
@@ -38,6 +46,7 @@ LSTM_BEGIN
         }
 
         epoch_t version() const noexcept { return transaction_base::version(); }
+        transaction_domain& domain() const noexcept { return get_thread_data().domain(); }
 
         bool valid(const thread_data& td) const noexcept { return transaction_base::valid(&td); }
         bool read_write_valid(const epoch_t version) const noexcept { return rw_valid(version); }
@@ -45,6 +54,23 @@ LSTM_BEGIN
         bool read_valid(const epoch_t version) const noexcept { return rw_valid(version); }
         bool read_valid(const detail::var_base& v) const noexcept { return rw_valid(v); }
 
+        // early release: v is no longer validated, so writes to it no longer conflict with this
+        // transaction, and no longer wake it from lstm::retry. whatever was read from v before
+        // the release may then be out of date by the time the transaction commits
+        void release(const detail::var_base& v) const noexcept { rw_release(v); }
+
+        template<typename T, typename Alloc>
+        void release(const var<T, Alloc>& v) const noexcept
+        {
+            v.release(*this);
+        }
+
+        template<typename T, typename Alloc>
+        void release(const multi_version_var<T, Alloc>& v) const noexcept
+        {
+            v.release(*this);
+        }
+
         template<typename Func,
                  LSTM_REQUIRES_(std::is_constructible<detail::gp_callback, Func&&>{})>
         void sometime_synchronized_after(Func&& func) const
@@ -60,6 +86,16 @@ LSTM_BEGIN
         {
             transaction_base::after_fail((Func &&) func);
         }
+
+        // runs func once the transaction commits, before reclaiming what it replaced. side effects
+        // such as logging or replying to a client belong here, rather than in the transaction
+        template<typename Func,
+                 LSTM_REQUIRES_(std::is_constructible<detail::gp_callback, Func&&>{})>
+        void after_commit(Func&& func) const
+            noexcept(noexcept(transaction_base::after_commit((Func &&) func)))
+        {
+            transaction_base::after_commit((Func &&) func);
+        }
     };
 LSTM_END
 
@@ -0,0 +1,277 @@
+#ifndef LSTM_TRANSACTION_DOMAIN_HPP
+#define LSTM_TRANSACTION_DOMAIN_HPP
+
+#include <lstm/clock.hpp>
+#include <lstm/contention_manager.hpp>
+#include <lstm/detail/thread_synchronization.hpp>
+
+LSTM_DETAIL_BEGIN
+    struct clock_policy
+    {
+        epoch_t (*get_clock)(const std::atomic<epoch_t>&) noexcept;
+        epoch_t (*fetch_and_bump_clock)(std::atomic<epoch_t>&) noexcept;
+        void (*advance_past)(std::atomic<epoch_t>&, epoch_t) noexcept;
+        bool ordered_commits;
+    };
+
+    template<typename Clock>
+    const clock_policy* clock_policy_for() noexcept
+    {
+        static constexpr clock_policy policy{&Clock::get_clock,
+                                             &Clock::fetch_and_bump_clock,
+                                             &Clock::advance_past,
+                                             Clock::ordered_commits};
+        return &policy;
+    }
+
+    // gv1 is the default, and is special cased to avoid the indirect calls
+    template<>
+    inline const clock_policy* clock_policy_for<gv1_clock>() noexcept
+    {
+        return nullptr;
+    }
+
+    struct contention_policy
+    {
+        void (*backoff)(const contention_info&) noexcept;
+        std::size_t (*lock_spins)(const contention_info&) noexcept;
+        bool (*irrevocable)(const contention_info&) noexcept;
+    };
+
+    template<typename ContentionManager>
+    const contention_policy* contention_policy_for() noexcept
+    {
+        static constexpr contention_policy policy{&ContentionManager::backoff,
+                                                  &ContentionManager::lock_spins,
+                                                  contention_irrevocable_fn<ContentionManager>()};
+        return &policy;
+    }
+
+    // as with gv1, the default contention manager is special cased
+    template<>
+    inline const contention_policy* contention_policy_for<yield_manager>() noexcept
+    {
+        return nullptr;
+    }
+LSTM_DETAIL_END
+
+LSTM_BEGIN
+    // how read write transactions in a domain take ownership of the vars they write
+    //  - commit_time: writes are buffered in the write set, and locked only while committing
+    //  - encounter_time: vars are locked on their first write, and updated in place. an undo log
+    //    restores them if the transaction fails. suits write heavy workloads with few conflicts
+    enum class locking_mode : char
+    {
+        commit_time = 0,
+        encounter_time,
+    };
+
+    // how read write transactions in a domain publish their writes once validated
+    //  - individual: each commit bumps the clock, and publishes its own writes
+    //  - combining: commits post themselves to the domain, and whichever thread takes the combiner
+    //    lock publishes every posted commit with a single clock bump. suits many threads committing
+    //    small, disjoint write sets at once
+    enum class commit_mode : char
+    {
+        individual = 0,
+        combining,
+    };
+
+    // a transaction_domain owns a clock, and scopes memory reclamation to the threads running
+    // transactions inside of it. vars must only ever be accessed from transactions in a single
+    // domain, and a domain must outlive every transaction run in it. it must not be destroyed from
+    // inside of a transaction. threads may outlive it, and reclaim what they queued in it without
+    // waiting. with LSTM_NOREC defined, the clock is a sequence lock, and clock policies, locking
+    // modes and commit modes have no effect
+    struct transaction_domain
+    {
+    private:
+        LSTM_CACHE_ALIGNED std::atomic<epoch_t> clock;
+        const detail::clock_policy*             policy;
+        const detail::contention_policy*        contention;
+        locking_mode                            locking;
+        commit_mode                             committing;
+
+        // only used by commit_mode::combining
+        LSTM_CACHE_ALIGNED std::atomic<thread_data*> commit_requests;
+        std::atomic<bool>                            combining;
+
+        // the irrevocable transaction running in the domain, if any
+        std::atomic<thread_data*>   irrevocable_owner;
+        // the threads blocked in lstm::retry, and the hashes of the vars they read. commits looking
+        // for threads to wake share the lock, so it is only held exclusively to add or remove one
+        detail::fast_rw_mutex       retry_lock;
+        detail::retry_waiter*       retry_head;
+        std::atomic<detail::hash_t> retry_waits;
+
+        friend detail::atomic_base_fn;
+        friend detail::commit_algorithm;
+        friend detail::retry_waiters;
+
+        // the public constructors all delegate here
+        inline constexpr transaction_domain(const detail::clock_policy*      in_policy,
+                                            const detail::contention_policy* in_contention,
+                                            const locking_mode               mode,
+                                            const commit_mode                in_commit) noexcept
+            : clock{0}
+            , policy{in_policy}
+            , contention{in_contention}
+            , locking{mode}
+            , committing{in_commit}
+            , commit_requests{nullptr}
+            , combining{false}
+            , irrevocable_owner{nullptr}
+            , retry_lock{}
+            , retry_head{nullptr}
+            , retry_waits{0}
+        {
+        }
+
+    public:
+        inline constexpr transaction_domain() noexcept
+            : transaction_domain(locking_mode::commit_time)
+        {
+        }
+
+        inline constexpr explicit transaction_domain(
+            const locking_mode mode,
+            const commit_mode  in_commit_mode = commit_mode::individual) noexcept
+            : transaction_domain(nullptr, nullptr, mode, in_commit_mode)
+        {
+        }
+
+        template<typename Clock>
+        explicit transaction_domain(
+            Clock,
+            const locking_mode mode           = locking_mode::commit_time,
+            const commit_mode  in_commit_mode = commit_mode::individual) noexcept
+            : transaction_domain(detail::clock_policy_for<Clock>(), nullptr, mode, in_commit_mode)
+        {
+        }
+
+        template<typename Clock,
+                 typename ContentionManager,
+                 LSTM_REQUIRES_(detail::is_contention_manager<ContentionManager>{})>
+        explicit transaction_domain(
+            Clock,
+            ContentionManager,
+            const locking_mode mode           = locking_mode::commit_time,
+            const commit_mode  in_commit_mode = commit_mode::individual) noexcept
+            : transaction_domain(detail::clock_policy_for<Clock>(),
+                                 detail::contention_policy_for<ContentionManager>(),
+                                 mode,
+                                 in_commit_mode)
+        {
+        }
+
+        transaction_domain(const transaction_domain&) = delete;
+        transaction_domain& operator=(const transaction_domain&) = delete;
+
+        ~transaction_domain() noexcept
+        {
+            LSTM_ASSERT(!retry_head);
+            LSTM_ASSERT(!irrevocable_owner.load(LSTM_RELAXED));
+            detail::domain_retirement::retire(*this);
+        }
+
+        inline epoch_t get_clock() const noexcept
+        {
+#ifndef LSTM_NOREC
+            if (LSTM_LIKELY(!policy))
+                return gv1_clock::get_clock(clock);
+            return policy->get_clock(clock);
+#else
+            // waits out the commit holding the sequence lock
+            epoch_t result = clock.load(LSTM_ACQUIRE);
+            while (LSTM_UNLIKELY(detail::locked(result)))
+                result = clock.load(LSTM_ACQUIRE);
+            return result;
+#endif
+        }
+
+        // returns the sync epoch. writes are published at the sync epoch + bump_size()
+        inline epoch_t fetch_and_bump_clock() noexcept
+        {
+            const epoch_t result = LSTM_LIKELY(!policy) ? gv1_clock::fetch_and_bump_clock(clock)
+                                                        : policy->fetch_and_bump_clock(clock);
+            LSTM_ASSERT(result < max_version() - bump_size());
+            return result;
+        }
+
+        // as fetch_and_bump_clock, but the commit is always ordered after the transactions that
+        // read the clock before it. lazy clocks fall back to gv1 for the commit
+        inline epoch_t fetch_and_bump_clock_ordered() noexcept
+        {
+            if (LSTM_LIKELY(!policy) || !policy->ordered_commits) {
+                const epoch_t result = gv1_clock::fetch_and_bump_clock(clock);
+                LSTM_ASSERT(result < max_version() - bump_size());
+                return result;
+            }
+            return fetch_and_bump_clock();
+        }
+
+#ifndef LSTM_NOREC
+        inline locking_mode get_locking_mode() const noexcept { return locking; }
+        inline commit_mode  get_commit_mode() const noexcept { return committing; }
+
+        inline void advance_past(const epoch_t epoch) noexcept
+        {
+            if (LSTM_UNLIKELY(policy))
+                policy->advance_past(clock, epoch);
+        }
+#else
+        // there are no per var locks to take on encounter
+        inline locking_mode get_locking_mode() const noexcept { return locking_mode::commit_time; }
+        inline commit_mode  get_commit_mode() const noexcept { return commit_mode::individual; }
+
+        inline void advance_past(const epoch_t) noexcept {}
+
+        // the clock doubles as a sequence lock. it is taken by a single CAS from the version the
+        // committing transaction last validated at, and released at the next version. the CAS is
+        // sequentially consistent, as threads blocking in lstm::retry check the lock after
+        // registering
+        inline epoch_t load_sequence_lock() const noexcept { return clock.load(LSTM_ACQUIRE); }
+
+        inline bool try_lock_sequence(epoch_t version) noexcept
+        {
+            LSTM_ASSERT(!detail::locked(version));
+            return clock.compare_exchange_strong(version,
+                                                 detail::as_locked(version),
+                                                 LSTM_SEQ_CST,
+                                                 LSTM_RELAXED);
+        }
+
+        inline void unlock_sequence(const epoch_t version) noexcept
+        {
+            LSTM_ASSERT(clock.load(LSTM_RELAXED) == detail::as_locked(version));
+            LSTM_ASSERT(version < max_version() - bump_size());
+            clock.store(version + bump_size(), LSTM_RELEASE);
+        }
+#endif
+
+        static inline constexpr epoch_t bump_size() noexcept { return 1; }
+        static inline constexpr epoch_t max_version() noexcept
+        {
+            return ~(epoch_t(1) << (sizeof(epoch_t) * 8 - bump_size()));
+        }
+    };
+
+    template<typename Clock, typename ContentionManager = yield_manager>
+    struct basic_transaction_domain : transaction_domain
+    {
+        explicit basic_transaction_domain(
+            const locking_mode mode           = locking_mode::commit_time,
+            const commit_mode  in_commit_mode = commit_mode::individual) noexcept
+            : transaction_domain(Clock{}, ContentionManager{}, mode, in_commit_mode)
+        {
+        }
+    };
+
+    inline transaction_domain& default_domain() noexcept
+    {
+        static transaction_domain _default_domain{};
+        return _default_domain;
+    }
+LSTM_END
+
+#endif /* LSTM_TRANSACTION_DOMAIN_HPP */
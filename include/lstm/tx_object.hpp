@@ -0,0 +1,143 @@
+#ifndef LSTM_TX_OBJECT_HPP
+#define LSTM_TX_OBJECT_HPP
+
+#include <lstm/var.hpp>
+
+#include <tuple>
+
+LSTM_BEGIN
+    // a group of fields guarded by a single version lock. the fields live together in the storage
+    // of one var, so reading any number of them is a single read set entry, and writing any number
+    // of them locks a single word at commit. in exchange, the first write to the object in a
+    // transaction copies every field, and writes to different fields of the object conflict.
+    // later writes in the transaction change only their field of that copy
+    template<typename Alloc, typename... Fields>
+    struct basic_tx_object
+    {
+    public:
+        using fields_type    = std::tuple<Fields...>;
+        using allocator_type = Alloc;
+
+        template<std::size_t I>
+        using field_type = std::tuple_element_t<I, fields_type>;
+
+    private:
+        using var_t = var<fields_type, allocator_type>;
+
+        var_t fields;
+
+        // fields are read by reference, and written in place in the transaction's copy
+        static_assert(var_t::heap, "lstm::tx_object<> fields must be stored on the heap");
+
+    public:
+        LSTM_REQUIRES(std::is_default_constructible<fields_type>{}
+                      && std::is_default_constructible<allocator_type>{})
+        basic_tx_object() noexcept(std::is_nothrow_constructible<var_t>{})
+            : fields()
+        {
+        }
+
+        template<typename... Us,
+                 LSTM_REQUIRES_(sizeof...(Us) == sizeof...(Fields)
+                                && std::is_constructible<fields_type, Us&&...>{}
+                                && std::is_default_constructible<allocator_type>{})>
+        explicit basic_tx_object(Us&&... us) noexcept(
+            std::is_nothrow_constructible<var_t, fields_type&&>{}
+            && std::is_nothrow_constructible<fields_type, Us&&...>{})
+            : fields(fields_type((Us &&) us...))
+        {
+        }
+
+        template<typename... Us,
+                 LSTM_REQUIRES_(sizeof...(Us) == sizeof...(Fields)
+                                && std::is_constructible<fields_type, Us&&...>{})>
+        basic_tx_object(std::allocator_arg_t,
+                        const allocator_type& alloc,
+                        Us&&... us) noexcept(std::is_nothrow_constructible<var_t,
+                                                                          std::allocator_arg_t,
+                                                                          const allocator_type&,
+                                                                          fields_type&&>{}
+                                             && std::is_nothrow_constructible<fields_type,
+                                                                              Us&&...>{})
+            : fields(std::allocator_arg, alloc, fields_type((Us &&) us...))
+        {
+        }
+
+        allocator_type get_allocator() const noexcept { return fields.get_allocator(); }
+
+        const fields_type& unsafe_get() const noexcept { return fields.unsafe_get(); }
+
+        template<std::size_t I>
+        const field_type<I>& unsafe_get() const noexcept
+        {
+            return std::get<I>(fields.unsafe_get());
+        }
+
+        template<std::size_t I,
+                 typename U = field_type<I>,
+                 LSTM_REQUIRES_(std::is_assignable<field_type<I>&, U&&>{})>
+        void unsafe_set(U&& u)
+        {
+            fields_type copy = fields.unsafe_get();
+            std::get<I>(copy) = (U &&) u;
+            fields.unsafe_set(std::move(copy));
+        }
+
+        // reads, and validates, every field at once
+        const fields_type& get(const transaction tx) const { return fields.get(tx); }
+        const fields_type& get(const read_transaction tx) const { return fields.get(tx); }
+
+        template<std::size_t I>
+        const field_type<I>& get(const transaction tx) const
+        {
+            return std::get<I>(fields.get(tx));
+        }
+
+        template<std::size_t I>
+        const field_type<I>& get(const read_transaction tx) const
+        {
+            return std::get<I>(fields.get(tx));
+        }
+
+        template<std::size_t I>
+        const field_type<I>& untracked_get(const transaction tx) const
+        {
+            return std::get<I>(fields.untracked_get(tx));
+        }
+
+        template<std::size_t I>
+        const field_type<I>& untracked_get(const read_transaction tx) const
+        {
+            return std::get<I>(fields.untracked_get(tx));
+        }
+
+        // the other fields are read as they are in the transaction, so that they are written back
+        // unchanged
+        template<std::size_t I,
+                 typename U = field_type<I>,
+                 LSTM_REQUIRES_(std::is_assignable<field_type<I>&, U&&>{})>
+        void set(const transaction tx, U&& u)
+        {
+            fields.update(tx, [&](fields_type& f) { std::get<I>(f) = (U &&) u; });
+        }
+
+        // calls f with the transaction's copy of the fields, and writes back whatever f leaves in
+        // it. several fields are then changed at once
+        template<typename F, LSTM_REQUIRES_(detail::callable<F&, fields_type&>{})>
+        void update(const transaction tx, F&& f)
+        {
+            fields.update(tx, f);
+        }
+
+        void release(const transaction tx) const noexcept { fields.release(tx); }
+        void release(const read_transaction tx) const noexcept { fields.release(tx); }
+
+        // whether info describes an attempt that failed on this object
+        bool caused(const contention_info& info) const noexcept { return fields.caused(info); }
+    };
+
+    template<typename... Fields>
+    using tx_object = basic_tx_object<std::allocator<std::tuple<Fields...>>, Fields...>;
+LSTM_END
+
+#endif /* LSTM_TX_OBJECT_HPP */
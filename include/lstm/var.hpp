@@ -13,6 +13,9 @@ LSTM_BEGIN
         using base = detail::var_alloc_policy<T, Alloc>;
 
         friend struct ::lstm::detail::transaction_base;
+        friend struct ::lstm::detail::single_var_fn;
+        template<std::size_t>
+        friend struct ::lstm::hand_over_hand;
 
     public:
         using value_type                 = T;
@@ -322,6 +325,22 @@ LSTM_BEGIN
             return tx.ro_untracked_read(*this);
         }
 
+        void release(const transaction tx) const noexcept
+        {
+            tx.release(static_cast<const detail::var_base&>(*this));
+        }
+
+        void release(const read_transaction tx) const noexcept
+        {
+            tx.release(static_cast<const detail::var_base&>(*this));
+        }
+
+        // whether info describes an attempt that failed on this var
+        bool caused(const contention_info& info) const noexcept
+        {
+            return info.var == static_cast<const detail::var_base*>(this);
+        }
+
         template<typename U = value_type,
                  LSTM_REQUIRES_(std::is_assignable<value_type&, U&&>()
                                 && std::is_constructible<value_type, U&&>())>
@@ -330,6 +349,44 @@ LSTM_BEGIN
             tx.rw_write(*this, (U &&) u);
         }
 
+        // calls f with the value, and writes back whatever f leaves in it. only the first update
+        // or set in a transaction copies the value, later updates change that copy in place
+        template<typename F, LSTM_REQUIRES_(!atomic && detail::callable<F&, value_type&>{})>
+        LSTM_ALWAYS_INLINE void update(const transaction tx, F&& f)
+        {
+            tx.rw_update(*this, f);
+        }
+
+        // commutative updates. the transaction records the update instead of reading the var, and
+        // applies it as the commit locks the var. transactions that only update the var this way
+        // then never conflict over it. reading the var afterwards reads it as usual
+        LSTM_REQUIRES(atomic && std::is_arithmetic<value_type>{}
+                      && !std::is_same<value_type, bool>{})
+        LSTM_ALWAYS_INLINE void add(const transaction tx, const value_type& delta)
+        {
+            tx.rw_defer(*this, delta, detail::deferred_add{});
+        }
+
+        // stores the lesser of the value and x
+        LSTM_REQUIRES(atomic && std::is_arithmetic<value_type>{})
+        LSTM_ALWAYS_INLINE void lower_to(const transaction tx, const value_type& x)
+        {
+            tx.rw_defer(*this, x, detail::deferred_min{});
+        }
+
+        // stores the greater of the value and x
+        LSTM_REQUIRES(atomic && std::is_arithmetic<value_type>{})
+        LSTM_ALWAYS_INLINE void raise_to(const transaction tx, const value_type& x)
+        {
+            tx.rw_defer(*this, x, detail::deferred_max{});
+        }
+
+        LSTM_REQUIRES(atomic && std::is_integral<value_type>{})
+        LSTM_ALWAYS_INLINE void set_bits(const transaction tx, const value_type& mask)
+        {
+            tx.rw_defer(*this, mask, detail::deferred_or{});
+        }
+
 #ifndef LSTM_MAKE_SFINAE_FRIENDLY
         template<typename U = value_type,
                  LSTM_REQUIRES_(!std::is_assignable<value_type&, U&&>()
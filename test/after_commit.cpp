@@ -0,0 +1,138 @@
+#include <lstm/lstm.hpp>
+
+#include "contention_helpers.hpp"
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+#include <atomic>
+#include <vector>
+
+static constexpr int loop_count   = LSTM_TEST_INIT(50000, 500);
+static constexpr int thread_count = 4;
+
+struct oops
+{
+};
+
+// callbacks run once, after the commit, and only for the attempt that commits
+static void runs_after_commit()
+{
+    lstm::var<int> x{0};
+    int            attempts = 0;
+    int            runs     = 0;
+    lstm::atomic([&](const lstm::transaction tx) {
+        x.set(tx, x.get(tx) + 1);
+        tx.after_commit([&]() noexcept {
+            CHECK(x.unsafe_get() == 43);
+            ++runs;
+        });
+        if (++attempts == 1)
+            commit_on_other_thread(x);
+    });
+    CHECK(attempts == 2);
+    CHECK(runs == 1);
+
+    try {
+        lstm::atomic([&](const lstm::transaction tx) {
+            tx.after_commit([&]() noexcept { ++runs; });
+            throw oops{};
+        });
+    } catch (const oops&) {
+    }
+    CHECK(runs == 1);
+
+    lstm::atomic([&](const lstm::transaction tx) {
+        lstm::or_else(tx,
+                      [&] {
+                          tx.after_commit([&]() noexcept { runs += 10; });
+                          lstm::retry();
+                      },
+                      [&] { tx.after_commit([&]() noexcept { ++runs; }); });
+    });
+    CHECK(runs == 2);
+}
+
+struct batch_sink
+{
+    std::vector<std::vector<int>>* batches;
+
+    void operator()(const int* first, const int* last) const noexcept
+    {
+        batches->emplace_back(first, last);
+    }
+};
+
+// effects reach the sink in batches, in the order they were pushed
+static void batches()
+{
+    std::vector<std::vector<int>> batches;
+    {
+        lstm::effect_queue<int, batch_sink> queue{4, batch_sink{&batches}};
+        for (int i = 0; i < 10; ++i) {
+            lstm::atomic([&](const lstm::transaction tx) { queue.push(tx, i); });
+            try {
+                lstm::atomic([&](const lstm::transaction tx) {
+                    queue.push(tx, -1);
+                    throw oops{};
+                });
+            } catch (const oops&) {
+            }
+        }
+        CHECK(queue.size() == 2u);
+    }
+
+    CHECK(batches.size() == 3u);
+    CHECK(batches[0] == (std::vector<int>{0, 1, 2, 3}));
+    CHECK(batches[1] == (std::vector<int>{4, 5, 6, 7}));
+    CHECK(batches[2] == (std::vector<int>{8, 9}));
+}
+
+static std::atomic<int> flushed{0};
+
+struct count_sink
+{
+    void operator()(const int* first, const int* last) const noexcept
+    {
+        flushed.fetch_add(int(last - first), std::memory_order_relaxed);
+    }
+};
+
+// each thread batches its own effects
+static void threads()
+{
+    lstm::var<int> x{0};
+    thread_manager manager;
+
+    for (int i = 0; i < thread_count; ++i) {
+        manager.queue_thread([&] {
+            lstm::effect_queue<int, count_sink> queue{64};
+            for (int j = 0; j < loop_count; ++j) {
+                lstm::atomic([&](const lstm::transaction tx) {
+                    const int value = x.get(tx) + 1;
+                    x.set(tx, value);
+                    queue.push(tx, value);
+                });
+            }
+        });
+    }
+
+    manager.run();
+
+    CHECK(x.unsafe_get() == thread_count * loop_count);
+    CHECK(flushed.load() == thread_count * loop_count);
+}
+
+int main()
+{
+    {
+        thread_manager manager;
+        manager.queue_thread([] {
+            runs_after_commit();
+            batches();
+        });
+        manager.run();
+    }
+    threads();
+
+    return test_result();
+}
@@ -0,0 +1,104 @@
+#include <lstm/lstm.hpp>
+
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+#include <thread>
+#include <vector>
+
+static constexpr int loop_count = LSTM_TEST_INIT(20000, 200);
+
+static lstm::transaction_domain gv1_domain{};
+static lstm::transaction_domain etl_domain{lstm::locking_mode::encounter_time};
+static lstm::transaction_domain combining_domain{lstm::locking_mode::commit_time,
+                                                 lstm::commit_mode::combining};
+
+// a consumer blocks until the producer writes, instead of spinning
+static void blocks()
+{
+    lstm::var<int> ready{0};
+    lstm::var<int> other{0};
+    int            attempts = 0;
+    std::thread    consumer{[&] {
+        lstm::atomic([&](const lstm::transaction tx) {
+            ++attempts;
+            if (!ready.get(tx))
+                lstm::retry();
+        });
+    }};
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    // commits to vars the consumer never read leave it blocked
+    lstm::atomic([&](const lstm::transaction tx) { other.set(tx, 1); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    lstm::atomic([&](const lstm::transaction tx) { ready.set(tx, 1); });
+    consumer.join();
+
+    CHECK(attempts <= 3);
+}
+
+// a read set too large for its hash to tell commits apart is searched instead. commits to vars
+// outside of it leave the consumer blocked, however many there are
+static void blocks_on_many()
+{
+    static constexpr int var_count = 256;
+
+    std::vector<lstm::var<int>> reads(var_count);
+    std::vector<lstm::var<int>> others(var_count / 8);
+    int                         attempts = 0;
+    std::thread                 consumer{[&] {
+        lstm::atomic([&](const lstm::transaction tx) {
+            ++attempts;
+            int sum = 0;
+            for (const lstm::var<int>& v : reads)
+                sum += v.get(tx);
+            if (!sum)
+                lstm::retry();
+        });
+    }};
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    for (lstm::var<int>& v : others) {
+        lstm::atomic([&](const lstm::transaction tx) { v.set(tx, 1); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    lstm::atomic([&](const lstm::transaction tx) { reads[var_count / 2].set(tx, 1); });
+    consumer.join();
+
+    CHECK(attempts <= 3);
+}
+
+// two threads take turns. every turn needs a wake up, so a lost one hangs the test
+static void ping_pong(lstm::transaction_domain& domain)
+{
+    lstm::var<int> turn{0};
+    thread_manager manager;
+
+    for (int i = 0; i < 2; ++i) {
+        manager.queue_loop_n(
+            [&, i] {
+                lstm::atomic(domain, [&](const lstm::transaction tx) {
+                    if (turn.get(tx) != i)
+                        lstm::retry();
+                    turn.set(tx, 1 - i);
+                });
+            },
+            loop_count);
+    }
+
+    manager.run();
+    CHECK(turn.unsafe_get() == 0);
+}
+
+int main()
+{
+    blocks();
+    blocks_on_many();
+
+    ping_pong(gv1_domain);
+    ping_pong(etl_domain);
+    ping_pong(combining_domain);
+
+    return test_result();
+}
@@ -0,0 +1,93 @@
+#define LSTM_BLOOM_HASHES 2
+#include <lstm/lstm.hpp>
+
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+#include <bitset>
+
+static constexpr int loop_count   = LSTM_TEST_INIT(20000, 200);
+static constexpr int thread_count = 4;
+static constexpr int node_count   = 64;
+
+// vars a cache line apart, like nodes handed out by the same allocator
+struct LSTM_CACHE_ALIGNED node
+{
+    lstm::var<int> value{0};
+};
+
+static node nodes[node_count];
+
+// once the alignment is shifted out, the addresses of the nodes are a fixed stride apart, so
+// dumb_reference_hash maps them all to a fraction of the filter
+static void spreads()
+{
+    lstm::detail::hash_t dumb_filter  = 0;
+    lstm::detail::hash_t mixed_filter = 0;
+    for (node& n : nodes) {
+        const lstm::detail::hash_t hash = lstm::detail::reference_hash(n.value);
+        CHECK(std::bitset<64>(hash).count() <= 2u);
+        dumb_filter |= lstm::detail::dumb_reference_hash(n.value);
+        mixed_filter |= hash;
+    }
+    for (node& n : nodes)
+        CHECK(lstm::detail::may_contain(mixed_filter, lstm::detail::reference_hash(n.value)));
+
+    CHECK(std::bitset<64>(mixed_filter).count() > 2 * std::bitset<64>(dumb_filter).count());
+}
+
+static void read_own_writes()
+{
+    lstm::atomic([&](const lstm::transaction tx) {
+        for (int i = 0; i < node_count; ++i) {
+            CHECK(nodes[i].value.get(tx) == 0);
+            nodes[i].value.set(tx, i);
+            CHECK(nodes[i / 2].value.get(tx) == i / 2);
+        }
+    });
+    for (int i = 0; i < node_count; ++i)
+        CHECK(nodes[i].value.unsafe_get() == i);
+
+    lstm::atomic([&](const lstm::transaction tx) {
+        for (node& n : nodes)
+            n.value.set(tx, 0);
+    });
+}
+
+static void transfers()
+{
+    thread_manager manager;
+
+    for (int i = 0; i < thread_count; ++i) {
+        manager.queue_loop_n(
+            [i] {
+                lstm::atomic([&](const lstm::transaction tx) {
+                    for (int j = i; j + 1 < node_count; j += thread_count) {
+                        nodes[j].value.set(tx, nodes[j].value.get(tx) - 1);
+                        nodes[j + 1].value.set(tx, nodes[j + 1].value.get(tx) + 1);
+                    }
+                });
+            },
+            loop_count);
+    }
+
+    manager.run();
+
+    int sum = 0;
+    for (node& n : nodes)
+        sum += n.value.unsafe_get();
+    CHECK(sum == 0);
+}
+
+int main()
+{
+    spreads();
+    {
+        thread_manager manager;
+        manager.queue_thread(read_own_writes);
+        manager.run();
+    }
+    transfers();
+
+    return test_result();
+}
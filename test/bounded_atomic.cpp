@@ -0,0 +1,134 @@
+#include <lstm/lstm.hpp>
+
+#include "contention_helpers.hpp"
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+#include <atomic>
+#include <chrono>
+
+static constexpr int loop_count   = LSTM_TEST_INIT(50000, 500);
+static constexpr int thread_count = 4;
+
+// a transaction that conflicts on every attempt gives up after its last one, and is rolled back
+static void attempt_limit()
+{
+    lstm::var<int> x{0};
+    lstm::var<int> y{0};
+    int            attempts  = 0;
+    bool           exhausted = false;
+    try {
+        lstm::atomic(lstm::with_attempt_limit(3, [&](const lstm::transaction tx) {
+            ++attempts;
+            y.set(tx, x.get(tx));
+            add_on_other_thread(x, 1);
+        }));
+    } catch (const lstm::budget_exhausted& e) {
+        exhausted = true;
+        CHECK(e.info.retries == 3u);
+        CHECK(e.info.reason != lstm::abort_reason::none);
+    }
+    CHECK(exhausted);
+    CHECK(attempts == 3);
+    CHECK(x.unsafe_get() == 3);
+    CHECK(y.unsafe_get() == 0);
+
+    // results pass through, and the budget is per call
+    attempts         = 0;
+    const int result = lstm::atomic(lstm::with_attempt_limit(2, [&](const lstm::transaction tx) {
+        const int value = x.get(tx);
+        y.set(tx, value);
+        if (++attempts == 1)
+            add_on_other_thread(x, 1);
+        return value;
+    }));
+    CHECK(attempts == 2);
+    CHECK(result == 4);
+    CHECK(y.unsafe_get() == 4);
+
+    attempts = 0;
+    try {
+        lstm::atomic(lstm::with_attempt_limit(2, [&](const lstm::read_transaction) {
+            ++attempts;
+            lstm::retry();
+        }));
+    } catch (const lstm::budget_exhausted&) {
+        ++attempts;
+    }
+    CHECK(attempts == 3);
+}
+
+// lstm::retry does not block past the deadline, as nothing will ever write to x
+static void deadline()
+{
+    using clock = std::chrono::steady_clock;
+
+    lstm::var<int>          x{0};
+    int                     attempts  = 0;
+    bool                    exhausted = false;
+    const clock::time_point start     = clock::now();
+    try {
+        lstm::atomic(lstm::with_deadline(start + std::chrono::milliseconds(10),
+                                         lstm::with_contention_manager<lstm::polite_manager<>>(
+                                             [&](const lstm::transaction tx) {
+                                                 ++attempts;
+                                                 if (x.get(tx) == 0)
+                                                     lstm::retry();
+                                             })));
+    } catch (const lstm::budget_exhausted& e) {
+        exhausted = true;
+        CHECK(e.info.reason == lstm::abort_reason::retry);
+    }
+    CHECK(exhausted);
+    CHECK(attempts > 1);
+    const clock::duration elapsed = clock::now() - start;
+    CHECK(elapsed >= std::chrono::milliseconds(10));
+
+    // a deadline already past still allows one attempt
+    const int result = lstm::atomic(
+        lstm::with_contention_manager<lstm::spin_manager<>>(lstm::with_deadline(start, [] {
+            return 42;
+        })));
+    CHECK(result == 42);
+}
+
+// every transaction either commits, or leaves no trace
+static void threads()
+{
+    lstm::var<int>   x{0};
+    std::atomic<int> commits{0};
+    thread_manager   manager;
+
+    for (int i = 0; i < thread_count; ++i) {
+        manager.queue_loop_n(
+            [&] {
+                try {
+                    lstm::atomic(lstm::with_attempt_limit(2, [&](const lstm::transaction tx) {
+                        x.set(tx, x.get(tx) + 1);
+                    }));
+                    commits.fetch_add(1, std::memory_order_relaxed);
+                } catch (const lstm::budget_exhausted&) {
+                }
+            },
+            loop_count);
+    }
+
+    manager.run();
+
+    CHECK(x.unsafe_get() == commits.load());
+}
+
+int main()
+{
+    {
+        thread_manager manager;
+        manager.queue_thread([] {
+            attempt_limit();
+            deadline();
+        });
+        manager.run();
+    }
+    threads();
+
+    return test_result();
+}
@@ -0,0 +1,117 @@
+#include <lstm/lstm.hpp>
+
+#include "../simple_test.hpp"
+#include "../thread_manager.hpp"
+
+#include <chrono>
+#include <random>
+
+static constexpr int iter_count       = LSTM_TEST_INIT(1000000, 10000);
+static constexpr int transfer_count   = LSTM_TEST_INIT(20000, 200);
+static constexpr int max_thread_count = 8;
+static constexpr int account_count    = 4;
+
+// every thread writes to its own var, so the clock is the only shared cache line written to
+struct LSTM_CACHE_ALIGNED padded_var
+{
+    lstm::var<int> value{0};
+};
+
+template<typename Clock>
+static void run_clock(const char* const name, const int thread_count)
+{
+    lstm::basic_transaction_domain<Clock> domain;
+    padded_var                            vars[max_thread_count];
+    padded_var                            shared;
+
+    thread_manager manager;
+    for (int t = 0; t < thread_count; ++t) {
+        manager.queue_loop_n(
+            [&domain, &shared, &counter = vars[t].value] {
+                lstm::atomic(domain, [&](const lstm::transaction tx) {
+                    counter.set(tx, counter.get(tx) + shared.value.get(tx) + 1);
+                });
+            },
+            iter_count);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    manager.run();
+    auto elapsed = std::chrono::high_resolution_clock::now() - start;
+    std::cout << name << " threads: " << thread_count << " elapsed: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()
+                     / 1000000.f
+              << "s" << std::endl;
+
+    for (int t = 0; t < thread_count; ++t)
+        CHECK(vars[t].value.unsafe_get() == iter_count);
+}
+
+// threads transfer between a few shared accounts, so commits race on the clock, and aborts advance
+// the lazy clocks past the versions they failed on. every snapshot must still add up
+template<typename Clock>
+static void run_contended(const char* const name, const int thread_count)
+{
+    lstm::basic_transaction_domain<Clock> domain;
+    lstm::var<int>                        accounts[account_count]{};
+    lstm::var<int>                        transfers{0};
+
+    thread_manager manager;
+    for (int t = 0; t < thread_count; ++t) {
+        manager.queue_thread([&, t] {
+            std::mt19937                       gen(t);
+            std::uniform_int_distribution<int> dist(0, account_count - 1);
+            for (int i = 0; i < transfer_count; ++i) {
+                const int from = dist(gen);
+                const int to   = dist(gen);
+                lstm::atomic(domain, [&](const lstm::transaction tx) {
+                    accounts[from].set(tx, accounts[from].get(tx) - 1);
+                    accounts[to].set(tx, accounts[to].get(tx) + 1);
+                    transfers.set(tx, transfers.get(tx) + 1);
+                });
+                lstm::read_only(domain, [&](const lstm::read_transaction tx) {
+                    int sum = 0;
+                    for (auto& account : accounts)
+                        sum += account.get(tx);
+                    CHECK(sum == 0);
+                });
+            }
+        });
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    manager.run();
+    auto elapsed = std::chrono::high_resolution_clock::now() - start;
+    std::cout << name << " contended threads: " << thread_count << " elapsed: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()
+                     / 1000000.f
+              << "s" << std::endl;
+
+    int sum = 0;
+    for (auto& account : accounts)
+        sum += account.unsafe_get();
+    CHECK(sum == 0);
+    CHECK(transfers.unsafe_get() == thread_count * transfer_count);
+}
+
+template<typename Clock>
+static void run(const char* const name, const int thread_count)
+{
+    run_clock<Clock>(name, thread_count);
+    run_contended<Clock>(name, thread_count);
+}
+
+int main()
+{
+    for (int thread_count = 1; thread_count <= max_thread_count; thread_count *= 2) {
+        run<lstm::gv1_clock>("gv1", thread_count);
+        run<lstm::gv4_clock>("gv4", thread_count);
+        run<lstm::gv5_clock>("gv5", thread_count);
+        run<lstm::gv6_clock<>>("gv6", thread_count);
+#ifdef LSTM_TSC_CLOCK_SUPPORT
+        run<lstm::tsc_clock>("tsc", thread_count);
+#endif
+    }
+
+    return test_result();
+}
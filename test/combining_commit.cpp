@@ -0,0 +1,89 @@
+#include <lstm/lstm.hpp>
+
+#ifdef NDEBUG
+#undef NDEBUG
+#include "debug_alloc.hpp"
+#define NDEBUG
+#else
+#include "debug_alloc.hpp"
+#endif
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+static constexpr int loop_count    = LSTM_TEST_INIT(50000, 500);
+static constexpr int thread_count  = 6;
+static constexpr int account_count = 16;
+
+using pair_var = lstm::var<std::pair<int, int>, debug_alloc<std::pair<int, int>>>;
+
+static lstm::transaction_domain gv1_domain{lstm::locking_mode::commit_time,
+                                           lstm::commit_mode::combining};
+static lstm::transaction_domain etl_domain{lstm::locking_mode::encounter_time,
+                                           lstm::commit_mode::combining};
+static lstm::basic_transaction_domain<lstm::gv5_clock> gv5_domain{lstm::locking_mode::commit_time,
+                                                                  lstm::commit_mode::combining};
+
+// most commits write to vars no other thread touches, and some transfer between shared accounts.
+// readers check that the totals never change
+static void transfers(lstm::transaction_domain& domain)
+{
+    lstm::var<int> own[thread_count]{};
+    lstm::var<int> accounts[account_count]{};
+    pair_var       pair{0, 0};
+    thread_manager manager;
+
+    for (int i = 0; i < thread_count; ++i) {
+        manager.queue_loop_n(
+            [&, i] {
+                lstm::atomic(domain, [&](const lstm::transaction tx) {
+                    own[i].set(tx, own[i].get(tx) + 1);
+                });
+                lstm::atomic(domain, [&](const lstm::transaction tx) {
+                    lstm::var<int>& from = accounts[(i * 5) % account_count];
+                    lstm::var<int>& to   = accounts[(i * 7 + 1) % account_count];
+                    from.set(tx, from.get(tx) - 1);
+                    to.set(tx, to.get(tx) + 1);
+                });
+                lstm::atomic(domain, [&](const lstm::transaction tx) {
+                    const auto p = pair.get(tx);
+                    pair.set(tx, {p.first + 1, p.second - 1});
+                });
+            },
+            loop_count);
+    }
+    manager.queue_loop_n(
+        [&] {
+            lstm::atomic(domain, [&](const lstm::read_transaction tx) {
+                int sum = 0;
+                for (auto& account : accounts)
+                    sum += account.get(tx);
+                CHECK(sum == 0);
+                const auto p     = pair.get(tx);
+                const int  total = p.first + p.second;
+                CHECK(total == 0);
+            });
+        },
+        loop_count);
+
+    manager.run();
+
+    int sum = 0;
+    for (auto& account : accounts)
+        sum += account.unsafe_get();
+    CHECK(sum == 0);
+    for (auto& v : own)
+        CHECK(v.unsafe_get() == loop_count);
+    CHECK(pair.unsafe_get()
+          == std::make_pair(thread_count * loop_count, -thread_count * loop_count));
+}
+
+int main()
+{
+    transfers(gv1_domain);
+    transfers(etl_domain);
+    transfers(gv5_domain);
+
+    CHECK(debug_live_allocations<> == 0);
+
+    return test_result();
+}
@@ -0,0 +1,57 @@
+#ifndef LSTM_TEST_CONTENTION_HELPERS_HPP
+#define LSTM_TEST_CONTENTION_HELPERS_HPP
+
+#include <lstm/atomic.hpp>
+#include <lstm/contention_manager.hpp>
+#include <lstm/var.hpp>
+
+#include <thread>
+
+// for tests only
+
+// commits to v from a thread of its own, in the middle of whatever transaction the calling thread
+// is running. int vars perform no allocations, so the other thread never waits on the grace period
+// of the calling thread
+inline void commit_on_other_thread(lstm::var<int>& v, const int value = 42)
+{
+    std::thread{[&] { lstm::atomic([&](const lstm::transaction tx) { v.set(tx, value); }); }}
+        .join();
+}
+
+inline void add_on_other_thread(lstm::var<int>& v, const int delta)
+{
+    std::thread{[&] { lstm::atomic([&](const lstm::transaction tx) { v.add(tx, delta); }); }}
+        .join();
+}
+
+// records every failed attempt, and never waits
+struct recording_manager
+{
+    static lstm::contention_info& last_info() noexcept
+    {
+        static lstm::contention_info info{};
+        return info;
+    }
+
+    static int& backoff_count() noexcept
+    {
+        static int count = 0;
+        return count;
+    }
+
+    static void reset() noexcept
+    {
+        last_info()     = {};
+        backoff_count() = 0;
+    }
+
+    static void backoff(const lstm::contention_info& info) noexcept
+    {
+        last_info() = info;
+        ++backoff_count();
+    }
+
+    static std::size_t lock_spins(const lstm::contention_info&) noexcept { return 0; }
+};
+
+#endif /* LSTM_TEST_CONTENTION_HELPERS_HPP */
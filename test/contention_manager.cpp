@@ -0,0 +1,167 @@
+#include <lstm/lstm.hpp>
+
+#include "contention_helpers.hpp"
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+static constexpr int loop_count    = LSTM_TEST_INIT(20000, 200);
+static constexpr int thread_count  = 4;
+static constexpr int account_count = 4;
+
+static_assert(lstm::detail::is_contention_manager<lstm::yield_manager>{}, "");
+static_assert(lstm::detail::is_contention_manager<lstm::greedy_manager<>>{}, "");
+static_assert(!lstm::detail::is_contention_manager<lstm::gv1_clock>{}, "");
+
+// every failure reaches the contention manager, with its retry count and reason
+static void abort_reasons()
+{
+    {
+        recording_manager::reset();
+        int attempts = 0;
+        lstm::atomic(lstm::with_contention_manager<recording_manager>([&] {
+            if (++attempts < 4)
+                lstm::retry();
+        }));
+        CHECK(attempts == 4);
+        CHECK(recording_manager::backoff_count() == 3);
+        CHECK(recording_manager::last_info().retries == 3u);
+        CHECK(recording_manager::last_info().reason == lstm::abort_reason::retry);
+        CHECK(recording_manager::last_info().cause == lstm::abort_cause::retry);
+        CHECK(recording_manager::last_info().var == nullptr);
+    }
+    {
+        recording_manager::reset();
+        lstm::var<int> x{0};
+        lstm::var<int> y{0};
+        int            attempts = 0;
+        lstm::atomic(lstm::with_contention_manager<recording_manager>(
+            [&](const lstm::transaction tx) {
+                ++attempts;
+                x.get(tx);
+                if (attempts == 1) {
+                    commit_on_other_thread(x);
+                    commit_on_other_thread(y);
+                }
+                y.get(tx);
+            }));
+        CHECK(attempts == 2);
+        CHECK(recording_manager::backoff_count() == 1);
+        CHECK(recording_manager::last_info().reason == lstm::abort_reason::conflict);
+        CHECK(recording_manager::last_info().cause == lstm::abort_cause::read_conflict);
+        CHECK(y.caused(recording_manager::last_info()));
+        CHECK(!x.caused(recording_manager::last_info()));
+        CHECK(recording_manager::last_info().reads == 1u);
+        CHECK(recording_manager::last_info().work == 1u);
+    }
+    {
+        recording_manager::reset();
+        lstm::var<int> x{0};
+        lstm::var<int> y{0};
+        int            attempts = 0;
+        lstm::atomic(lstm::with_contention_manager<recording_manager>(
+            [&](const lstm::transaction tx) {
+                ++attempts;
+                y.get(tx);
+                if (attempts == 1) {
+                    commit_on_other_thread(y);
+                    commit_on_other_thread(x);
+                }
+                x.set(tx, 1);
+            }));
+        CHECK(attempts == 2);
+        CHECK(recording_manager::last_info().reason == lstm::abort_reason::conflict);
+        CHECK(recording_manager::last_info().cause == lstm::abort_cause::write_conflict);
+        CHECK(x.caused(recording_manager::last_info()));
+    }
+    {
+        recording_manager::reset();
+        lstm::var<int> x{0};
+        lstm::var<int> y{0};
+        int            attempts = 0;
+        lstm::atomic(lstm::with_contention_manager<recording_manager>(
+            [&](const lstm::transaction tx) {
+                ++attempts;
+                y.set(tx, x.get(tx) + 1);
+                if (attempts == 1)
+                    commit_on_other_thread(x);
+            }));
+        CHECK(attempts == 2);
+        CHECK(recording_manager::backoff_count() == 1);
+        CHECK(recording_manager::last_info().reason == lstm::abort_reason::commit);
+        CHECK(recording_manager::last_info().cause == lstm::abort_cause::validation);
+#ifndef LSTM_NOREC
+        CHECK(x.caused(recording_manager::last_info()));
+#endif
+        CHECK(recording_manager::last_info().writes == 1u);
+        CHECK(y.unsafe_get() == 43);
+    }
+    {
+        recording_manager::reset();
+        lstm::var<int> x{0};
+        int            attempts = 0;
+        const int      result   = lstm::atomic(
+            lstm::with_contention_manager<recording_manager>([&](const lstm::read_transaction tx) {
+                if (++attempts < 3)
+                    lstm::retry();
+                return x.get(tx);
+            }));
+        CHECK(result == 0);
+        CHECK(recording_manager::backoff_count() == 2);
+    }
+}
+
+// transfers between a few shared accounts, with the contention manager of the domain
+template<typename ContentionManager>
+static void transfers()
+{
+    lstm::basic_transaction_domain<lstm::gv1_clock, ContentionManager> domain{};
+    lstm::var<int>                                                     accounts[account_count]{};
+    thread_manager                                                     manager;
+
+    for (int i = 0; i < thread_count; ++i) {
+        manager.queue_loop_n(
+            [&, i] {
+                lstm::atomic(domain, [&](const lstm::transaction tx) {
+                    lstm::var<int>& from = accounts[i % account_count];
+                    lstm::var<int>& to   = accounts[(i + 1) % account_count];
+                    from.set(tx, from.get(tx) - 1);
+                    to.set(tx, to.get(tx) + 1);
+                });
+            },
+            loop_count);
+    }
+    manager.queue_loop_n(
+        [&] {
+            lstm::atomic(domain, [&](const lstm::read_transaction tx) {
+                int sum = 0;
+                for (auto& account : accounts)
+                    sum += account.get(tx);
+                CHECK(sum == 0);
+            });
+        },
+        loop_count);
+
+    manager.run();
+
+    int sum = 0;
+    for (auto& account : accounts)
+        sum += account.unsafe_get();
+    CHECK(sum == 0);
+}
+
+int main()
+{
+    {
+        thread_manager manager;
+        manager.queue_thread(abort_reasons);
+        manager.run();
+    }
+
+    transfers<lstm::yield_manager>();
+    transfers<lstm::spin_manager<>>();
+    transfers<lstm::polite_manager<>>();
+    transfers<lstm::karma_manager<>>();
+    transfers<lstm::greedy_manager<>>();
+
+    return test_result();
+}
@@ -0,0 +1,149 @@
+#include <lstm/lstm.hpp>
+
+#include "contention_helpers.hpp"
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+static constexpr int loop_count   = LSTM_TEST_INIT(50000, 500);
+static constexpr int thread_count = 4;
+
+static lstm::transaction_domain combining_domain{lstm::locking_mode::commit_time,
+                                                 lstm::commit_mode::combining};
+#ifndef LSTM_NOREC
+static lstm::transaction_domain etl_domain{lstm::locking_mode::encounter_time};
+#endif
+
+static void operations()
+{
+    lstm::var<int>      x{5};
+    lstm::var<unsigned> bits{1};
+    lstm::atomic([&](const lstm::transaction tx) {
+        x.add(tx, 2);
+        x.add(tx, 3);
+        bits.set_bits(tx, 4);
+        bits.set_bits(tx, 8);
+    });
+    CHECK(x.unsafe_get() == 10);
+    CHECK(bits.unsafe_get() == 13u);
+
+    lstm::atomic([&](const lstm::transaction tx) {
+        x.raise_to(tx, 7);
+        x.raise_to(tx, 12);
+    });
+    CHECK(x.unsafe_get() == 12);
+    lstm::atomic([&](const lstm::transaction tx) {
+        x.lower_to(tx, 20);
+        x.lower_to(tx, 3);
+    });
+    CHECK(x.unsafe_get() == 3);
+
+    // reads see the updates made before them, and writes replace them
+    lstm::atomic([&](const lstm::transaction tx) {
+        x.add(tx, 2);
+        CHECK(x.get(tx) == 5);
+        x.add(tx, 1);
+        CHECK(x.get(tx) == 6);
+        x.raise_to(tx, 4);
+        CHECK(x.get(tx) == 6);
+    });
+    CHECK(x.unsafe_get() == 6);
+    lstm::atomic([&](const lstm::transaction tx) {
+        x.add(tx, 5);
+        x.set(tx, 1);
+        x.add(tx, 2);
+    });
+    CHECK(x.unsafe_get() == 3);
+}
+
+// commits to the var in the meantime do not conflict with deferred updates, unless the
+// transaction read it
+static void no_conflict()
+{
+    lstm::var<int> counter{0};
+    int            attempts = 0;
+    lstm::atomic([&](const lstm::transaction tx) {
+        counter.add(tx, 1);
+        if (++attempts == 1)
+            add_on_other_thread(counter, 10);
+    });
+    CHECK(attempts == 1);
+    CHECK(counter.unsafe_get() == 11);
+
+    attempts = 0;
+    lstm::atomic([&](const lstm::transaction tx) {
+        const int value = counter.get(tx);
+        counter.add(tx, value);
+        if (++attempts == 1)
+            add_on_other_thread(counter, 10);
+    });
+    CHECK(attempts == 2);
+    CHECK(counter.unsafe_get() == 42);
+}
+
+// restoring a savepoint brings back the updates deferred before it was taken
+static void savepoints()
+{
+    lstm::var<int> x{0};
+    lstm::var<int> y{0};
+    lstm::atomic([&](const lstm::transaction tx) {
+        x.add(tx, 1);
+        lstm::or_else(tx,
+                      [&] {
+                          x.add(tx, 10);
+                          CHECK(x.get(tx) == 11);
+                          lstm::retry();
+                      },
+                      [&] { y.set(tx, x.get(tx)); });
+    });
+    CHECK(x.unsafe_get() == 1);
+    CHECK(y.unsafe_get() == 1);
+}
+
+// concurrent increments, with a transaction now and then that reads the counter
+static void counts(lstm::transaction_domain& domain)
+{
+    lstm::var<int> counter{0};
+    lstm::var<int> high{0};
+    lstm::var<int> seen{0};
+    thread_manager manager;
+
+    for (int i = 0; i < thread_count; ++i) {
+        manager.queue_loop_n(
+            [&, i] {
+                lstm::atomic(domain, [&](const lstm::transaction tx) {
+                    counter.add(tx, 1);
+                    high.raise_to(tx, i);
+                    if (i == 0)
+                        seen.raise_to(tx, counter.get(tx));
+                });
+            },
+            loop_count);
+    }
+
+    manager.run();
+
+    CHECK(counter.unsafe_get() == thread_count * loop_count);
+    CHECK(high.unsafe_get() == thread_count - 1);
+    CHECK(seen.unsafe_get() <= thread_count * loop_count);
+    CHECK(seen.unsafe_get() >= loop_count);
+}
+
+int main()
+{
+    {
+        thread_manager manager;
+        manager.queue_thread([] {
+            operations();
+            no_conflict();
+            savepoints();
+        });
+        manager.run();
+    }
+    counts(lstm::default_domain());
+    counts(combining_domain);
+#ifndef LSTM_NOREC
+    counts(etl_domain);
+#endif
+
+    return test_result();
+}
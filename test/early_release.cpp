@@ -0,0 +1,158 @@
+#include <lstm/lstm.hpp>
+
+#include "contention_helpers.hpp"
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+static constexpr int loop_count   = LSTM_TEST_INIT(20000, 200);
+static constexpr int thread_count = 4;
+static constexpr int var_count    = 16;
+static constexpr int node_count   = 32;
+
+// released vars are no longer validated, but the rest of the read set still is
+static void releases()
+{
+    lstm::var<int> vars[var_count]{};
+    lstm::var<int> out{0};
+    int            attempts = 0;
+    lstm::atomic(lstm::with_contention_manager<recording_manager>([&](const lstm::transaction tx) {
+        ++attempts;
+        for (lstm::var<int>& v : vars)
+            v.get(tx);
+        for (int i = 1; i < var_count; ++i) {
+            if (i % 2)
+                vars[i].release(tx);
+            else
+                tx.release(vars[i]);
+        }
+        if (attempts == 1) {
+            commit_on_other_thread(vars[1]);
+            // the read is newer than the transaction, and the extension skips released vars
+            CHECK(vars[1].get(tx) == 42);
+            commit_on_other_thread(vars[2]);
+            commit_on_other_thread(vars[0]);
+        }
+        out.set(tx, vars[0].get(tx));
+    }));
+    CHECK(attempts == 2);
+    CHECK(recording_manager::last_info().reason == lstm::abort_reason::conflict);
+    CHECK(recording_manager::last_info().reads == 2u);
+    CHECK(out.unsafe_get() == 42);
+}
+
+// vars the transaction has written stay validated
+static void written_vars()
+{
+    lstm::var<int> v{0};
+    int            attempts = 0;
+    lstm::atomic([&](const lstm::transaction tx) {
+        v.set(tx, v.get(tx) + 1);
+        v.release(tx);
+        if (++attempts == 1)
+            commit_on_other_thread(v);
+    });
+    CHECK(attempts == 2);
+    CHECK(v.unsafe_get() == 43);
+
+    // read only transactions record nothing to release
+    lstm::read_only([&](const lstm::read_transaction tx) {
+        CHECK(v.get(tx) == 43);
+        v.release(tx);
+    });
+}
+
+struct node
+{
+    lstm::var<int>   value{0};
+    lstm::var<node*> next{nullptr};
+};
+
+static node nodes[node_count];
+
+static void link_nodes()
+{
+    for (int i = 0; i + 1 < node_count; ++i)
+        nodes[i].next.unsafe_set(&nodes[i + 1]);
+}
+
+// walks to the node at index, keeping only the last two nodes of the path in the read set
+static node& walk_to(const lstm::transaction tx, const int index)
+{
+    lstm::hand_over_hand<4> path{tx};
+    node*                   n = &nodes[0];
+    for (int i = 0; i < index; ++i) {
+        path.get(n->value);
+        n = path.get(n->next);
+    }
+    return *n;
+}
+
+// commits behind the window no longer conflict with the traversal, those within it still do
+static void traversal()
+{
+    int attempts = 0;
+    lstm::atomic([&](const lstm::transaction tx) {
+        node& last = walk_to(tx, node_count - 1);
+        if (++attempts == 1) {
+            commit_on_other_thread(nodes[0].value);
+            commit_on_other_thread(nodes[node_count / 2].value);
+        }
+        last.value.set(tx, last.value.get(tx) + 1);
+    });
+    CHECK(attempts == 1);
+
+    attempts = 0;
+    lstm::atomic(lstm::with_contention_manager<recording_manager>([&](const lstm::transaction tx) {
+        node& last = walk_to(tx, node_count - 1);
+        if (++attempts == 1)
+            commit_on_other_thread(nodes[node_count - 2].value);
+        last.value.set(tx, last.value.get(tx) + 1);
+    }));
+    CHECK(attempts == 2);
+    CHECK(recording_manager::last_info().reads <= 5u);
+    CHECK(nodes[node_count - 1].value.unsafe_get() == 2);
+
+    for (node& n : nodes)
+        n.value.unsafe_set(0);
+}
+
+// every transaction increments a node near the tail, and reads the path there through a window
+static void increments()
+{
+    thread_manager manager;
+
+    for (int i = 0; i < thread_count; ++i) {
+        manager.queue_loop_n(
+            [i] {
+                lstm::atomic([&](const lstm::transaction tx) {
+                    node& n = walk_to(tx, node_count - 1 - i);
+                    n.value.set(tx, n.value.get(tx) + 1);
+                });
+            },
+            loop_count);
+    }
+
+    manager.run();
+
+    int sum = 0;
+    for (node& n : nodes)
+        sum += n.value.unsafe_get();
+    CHECK(sum == thread_count * loop_count);
+}
+
+int main()
+{
+    link_nodes();
+    {
+        thread_manager manager;
+        manager.queue_thread([] {
+            releases();
+            written_vars();
+            traversal();
+        });
+        manager.run();
+    }
+    increments();
+
+    return test_result();
+}
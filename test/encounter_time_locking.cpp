@@ -0,0 +1,133 @@
+#include <lstm/lstm.hpp>
+
+#ifdef NDEBUG
+#undef NDEBUG
+#include "debug_alloc.hpp"
+#define NDEBUG
+#else
+#include "debug_alloc.hpp"
+#endif
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+static constexpr int loop_count = LSTM_TEST_INIT(200000, 2000);
+
+using pair_var = lstm::var<std::pair<int, int>, debug_alloc<std::pair<int, int>>>;
+
+static lstm::transaction_domain domain{lstm::locking_mode::encounter_time};
+
+struct oops
+{
+};
+
+// writes are visible to later reads, and nested transactions, of the same transaction
+static void read_own_writes()
+{
+    lstm::var<int> x{0};
+    pair_var       p{0, 0};
+    lstm::atomic(domain, [&](const lstm::transaction tx) {
+        x.set(tx, 1);
+        CHECK(x.get(tx) == 1);
+        x.set(tx, x.get(tx) + 1);
+        p.set(tx, {1, 2});
+        p.set(tx, {p.get(tx).second, 3});
+        lstm::atomic([&](const lstm::transaction nested_tx) {
+            CHECK(x.get(nested_tx) == 2);
+            CHECK(p.get(nested_tx) == std::make_pair(2, 3));
+            x.set(nested_tx, 3);
+        });
+        CHECK(x.get(tx) == 3);
+    });
+    CHECK(x.unsafe_get() == 3);
+    CHECK(p.unsafe_get() == std::make_pair(2, 3));
+}
+
+// an exception thrown after writing restores the previous values, and releases the locks
+static void rollback_on_exception()
+{
+    lstm::var<int> x{0};
+    pair_var       p{4, 5};
+    try {
+        lstm::atomic(domain, [&](const lstm::transaction tx) {
+            x.set(tx, 1);
+            p.set(tx, {6, 7});
+            p.set(tx, {8, 9});
+            throw oops{};
+        });
+        CHECK(false);
+    } catch (const oops&) {
+    }
+    CHECK(x.unsafe_get() == 0);
+    CHECK(p.unsafe_get() == std::make_pair(4, 5));
+
+    lstm::atomic(domain, [&](const lstm::transaction tx) {
+        x.set(tx, x.get(tx) + 1);
+        p.set(tx, {p.get(tx).first + 1, p.get(tx).second + 1});
+    });
+    CHECK(x.unsafe_get() == 1);
+    CHECK(p.unsafe_get() == std::make_pair(5, 6));
+}
+
+int main()
+{
+    CHECK(domain.get_locking_mode() == lstm::locking_mode::encounter_time);
+    CHECK(lstm::default_domain().get_locking_mode() == lstm::locking_mode::commit_time);
+
+    // run on their own threads, so that thread exit reclaims everything they freed
+    {
+        thread_manager manager;
+        manager.queue_thread(read_own_writes);
+        manager.queue_thread(rollback_on_exception);
+        manager.run();
+    }
+
+    // conflicting writers, and readers that must never observe a partial transfer
+    {
+        lstm::var<int> account0{1000};
+        lstm::var<int> account1{1000};
+        pair_var       counter{0, 0};
+        thread_manager manager;
+
+        for (int i = 0; i < 2; ++i) {
+            manager.queue_loop_n(
+                [&] {
+                    lstm::atomic(domain, [&](const lstm::transaction tx) {
+                        account0.set(tx, account0.get(tx) - 1);
+                        account1.set(tx, account1.get(tx) + 1);
+                        auto value = counter.get(tx);
+                        ++value.first;
+                        counter.set(tx, value);
+                        ++value.second;
+                        counter.set(tx, value);
+                    });
+                },
+                loop_count);
+            manager.queue_loop_n(
+                [&] {
+                    lstm::atomic(domain, [&](const lstm::transaction tx) {
+                        account1.set(tx, account1.get(tx) - 1);
+                        account0.set(tx, account0.get(tx) + 1);
+                    });
+                },
+                loop_count);
+        }
+        manager.queue_loop_n(
+            [&] {
+                lstm::read_only(domain, [&](const lstm::read_transaction tx) {
+                    CHECK((account0.get(tx) + account1.get(tx)) == 2000);
+                    const auto& value = counter.get(tx);
+                    CHECK(value.first == value.second);
+                });
+            },
+            loop_count);
+
+        manager.run();
+
+        CHECK(account0.unsafe_get() == 1000);
+        CHECK(account1.unsafe_get() == 1000);
+        CHECK(counter.unsafe_get() == std::make_pair(loop_count * 2, loop_count * 2));
+    }
+    CHECK(debug_live_allocations<> == 0);
+
+    return test_result();
+}
@@ -0,0 +1,3 @@
+#include <lstm/clock.hpp>
+
+int main() { return 0; }
\ No newline at end of file
@@ -0,0 +1,3 @@
+#include <lstm/detail/deferred_value_type.hpp>
+
+int main() { return 0; }
\ No newline at end of file
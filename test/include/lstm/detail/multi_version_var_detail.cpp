@@ -0,0 +1,3 @@
+#include <lstm/detail/multi_version_var_detail.hpp>
+
+int main() { return 0; }
\ No newline at end of file
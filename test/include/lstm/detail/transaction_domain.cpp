@@ -1,3 +0,0 @@
-#include <lstm/detail/transaction_domain.hpp>
-
-int main() { return 0; }
\ No newline at end of file
@@ -0,0 +1,3 @@
+#include <lstm/hand_over_hand.hpp>
+
+int main() { return 0; }
\ No newline at end of file
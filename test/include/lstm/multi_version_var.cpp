@@ -0,0 +1,3 @@
+#include <lstm/multi_version_var.hpp>
+
+int main() { return 0; }
\ No newline at end of file
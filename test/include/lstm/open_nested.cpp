@@ -0,0 +1,3 @@
+#include <lstm/open_nested.hpp>
+
+int main() { return 0; }
\ No newline at end of file
@@ -0,0 +1,3 @@
+#include <lstm/or_else.hpp>
+
+int main() { return 0; }
\ No newline at end of file
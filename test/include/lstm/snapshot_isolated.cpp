@@ -0,0 +1,3 @@
+#include <lstm/snapshot_isolated.hpp>
+
+int main() { return 0; }
\ No newline at end of file
@@ -0,0 +1,3 @@
+#include <lstm/transaction_domain.hpp>
+
+int main() { return 0; }
\ No newline at end of file
@@ -0,0 +1,3 @@
+#include <lstm/tx_object.hpp>
+
+int main() { return 0; }
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include <lstm/lstm.hpp>
+#include <lstm/multi_version_var.hpp>
+
+#ifdef NDEBUG
+#undef NDEBUG
+#include "debug_alloc.hpp"
+#define NDEBUG
+#else
+#include "debug_alloc.hpp"
+#endif
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+#include <thread>
+
+static constexpr int loop_count    = LSTM_TEST_INIT(20000, 200);
+static constexpr int thread_count  = 4;
+static constexpr int account_count = 8;
+
+using pair_var = lstm::var<std::pair<int, int>, debug_alloc<std::pair<int, int>>>;
+
+using irrevocable_domain = lstm::basic_transaction_domain<lstm::gv1_clock,
+                                                          lstm::irrevocable_after<4>>;
+
+static irrevocable_domain gv1_domain{};
+static irrevocable_domain etl_domain{lstm::locking_mode::encounter_time};
+static irrevocable_domain combining_domain{lstm::locking_mode::commit_time,
+                                           lstm::commit_mode::combining};
+
+static_assert(lstm::detail::is_contention_manager<lstm::irrevocable_after<1>>{}, "");
+
+// other commits wait for the irrevocable transaction to finish
+static void blocks_commits()
+{
+    lstm::var<int> x{0};
+    std::thread    writer;
+    int            attempts = 0;
+    lstm::atomic(lstm::irrevocable([&](const lstm::transaction tx) {
+        ++attempts;
+        CHECK(lstm::tls_thread_data().irrevocable());
+        const int x_ = x.get(tx);
+        writer       = std::thread{
+            [&] { lstm::atomic([&](const lstm::transaction tx) { x.set(tx, 42); }); }};
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        CHECK(x.get(tx) == x_);
+        x.set(tx, x_ + 1);
+    }));
+    writer.join();
+    CHECK(attempts == 1);
+    CHECK(!lstm::tls_thread_data().irrevocable());
+    CHECK(x.unsafe_get() == 42);
+}
+
+// transactions become irrevocable after failing as often as the contention manager allows
+static void after_retries()
+{
+    int attempts = 0;
+    lstm::atomic(lstm::with_contention_manager<lstm::irrevocable_after<2>>([&] {
+        ++attempts;
+        if (!lstm::tls_thread_data().irrevocable())
+            lstm::retry();
+    }));
+    CHECK(attempts == 3);
+}
+
+// an exception still rolls back the writes of an irrevocable transaction, and gives up the token
+static void exceptions()
+{
+    pair_var p{0, 0};
+    try {
+        lstm::atomic(lstm::irrevocable([&](const lstm::transaction tx) {
+            p.set(tx, {1, -1});
+            throw 0;
+        }));
+    } catch (int) {
+    }
+    CHECK(p.unsafe_get() == std::make_pair(0, 0));
+
+    lstm::atomic(lstm::irrevocable([&](const lstm::transaction tx) { p.set(tx, {2, -2}); }));
+    CHECK(p.unsafe_get() == std::make_pair(2, -2));
+}
+
+// transfers between a few shared accounts, while one thread rebalances every account at once
+static void rebalance(lstm::transaction_domain& domain)
+{
+    lstm::var<int>               accounts[account_count]{};
+    lstm::multi_version_var<int> rebalances{0};
+    pair_var                     pair{0, 0};
+    thread_manager               manager;
+
+    for (int i = 0; i < thread_count; ++i) {
+        manager.queue_loop_n(
+            [&, i] {
+                lstm::atomic(domain, [&](const lstm::transaction tx) {
+                    lstm::var<int>& from = accounts[i % account_count];
+                    lstm::var<int>& to   = accounts[(i * 3 + 1) % account_count];
+                    from.set(tx, from.get(tx) - 1);
+                    to.set(tx, to.get(tx) + 1);
+                    const auto p = pair.get(tx);
+                    pair.set(tx, {p.first + 1, p.second - 1});
+                });
+            },
+            loop_count);
+    }
+    manager.queue_loop_n(
+        [&] {
+            lstm::atomic(domain, lstm::irrevocable([&](const lstm::transaction tx) {
+                int sum = 0;
+                for (auto& account : accounts)
+                    sum += account.get(tx);
+                CHECK(sum == 0);
+                for (auto& account : accounts)
+                    account.set(tx, 0);
+                rebalances.set(tx, rebalances.get(tx) + 1);
+            }));
+        },
+        loop_count / 100);
+    manager.queue_loop_n(
+        [&] {
+            lstm::atomic(domain, [&](const lstm::read_transaction tx) {
+                int sum = 0;
+                for (auto& account : accounts)
+                    sum += account.get(tx);
+                CHECK(sum == 0);
+                const auto p     = pair.get(tx);
+                const int  total = p.first + p.second;
+                CHECK(total == 0);
+            });
+        },
+        loop_count);
+
+    manager.run();
+
+    int sum = 0;
+    for (auto& account : accounts)
+        sum += account.unsafe_get();
+    CHECK(sum == 0);
+    CHECK(rebalances.unsafe_get() == loop_count / 100);
+    CHECK(pair.unsafe_get()
+          == std::make_pair(thread_count * loop_count, -thread_count * loop_count));
+}
+
+int main()
+{
+    {
+        thread_manager manager;
+        manager.queue_thread([] {
+            blocks_commits();
+            after_retries();
+            exceptions();
+        });
+        manager.run();
+    }
+
+    rebalance(gv1_domain);
+    rebalance(etl_domain);
+    rebalance(combining_domain);
+
+    CHECK(debug_live_allocations<> == 0);
+
+    return test_result();
+}
@@ -0,0 +1,101 @@
+#include <lstm/lstm.hpp>
+
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+static constexpr int loop_count   = LSTM_TEST_INIT(200, 20);
+static constexpr int thread_count = 4;
+static constexpr int var_count    = 1000;
+
+static lstm::transaction_domain gv1_domain{};
+static lstm::transaction_domain etl_domain{lstm::locking_mode::encounter_time};
+
+// large write sets are searched through an index. every var must still be found, whether it was
+// written before or after the index was built
+static void read_own_writes()
+{
+    std::vector<lstm::var<int>> vars(var_count);
+    lstm::atomic([&](const lstm::transaction tx) {
+        for (int i = 0; i < var_count; ++i) {
+            CHECK(vars[i].get(tx) == 0);
+            vars[i].set(tx, i);
+            CHECK(vars[i / 2].get(tx) == i / 2);
+        }
+        for (int i = 0; i < var_count; ++i) {
+            CHECK(vars[i].get(tx) == i);
+            vars[i].set(tx, vars[i].get(tx) + 1);
+        }
+    });
+    for (int i = 0; i < var_count; ++i)
+        CHECK(vars[i].unsafe_get() == i + 1);
+}
+
+// restoring a savepoint drops the writes made after it from the index
+static void savepoints()
+{
+    std::vector<lstm::var<int>> vars(var_count);
+    lstm::atomic([&](const lstm::transaction tx) {
+        for (int i = 0; i < 20; ++i)
+            vars[i].set(tx, 1);
+        lstm::or_else(tx,
+                      [&] {
+                          for (int i = 0; i < var_count; ++i)
+                              vars[i].set(tx, 2);
+                          lstm::retry();
+                      },
+                      [&] {
+                          for (int i = 0; i < var_count; ++i)
+                              CHECK(vars[i].get(tx) == (i < 20 ? 1 : 0));
+                          for (int i = 20; i < 40; ++i)
+                              vars[i].set(tx, 3);
+                      });
+    });
+    for (int i = 0; i < var_count; ++i)
+        CHECK(vars[i].unsafe_get() == (i < 20 ? 1 : i < 40 ? 3 : 0));
+}
+
+// every transaction moves one unit between every pair of neighbouring vars
+static void large_transfers(lstm::transaction_domain& domain)
+{
+    std::vector<lstm::var<int>> vars(var_count / 4);
+    thread_manager              manager;
+
+    for (int i = 0; i < thread_count; ++i) {
+        manager.queue_loop_n(
+            [&] {
+                lstm::atomic(domain, [&](const lstm::transaction tx) {
+                    for (std::size_t j = 0; j + 1 < vars.size(); ++j) {
+                        vars[j].set(tx, vars[j].get(tx) - 1);
+                        vars[j + 1].set(tx, vars[j + 1].get(tx) + 1);
+                    }
+                });
+            },
+            loop_count);
+    }
+
+    manager.run();
+
+    int sum = 0;
+    for (auto& v : vars)
+        sum += v.unsafe_get();
+    CHECK(sum == 0);
+    CHECK(vars.front().unsafe_get() == -thread_count * loop_count);
+    CHECK(vars.back().unsafe_get() == thread_count * loop_count);
+}
+
+int main()
+{
+    {
+        thread_manager manager;
+        manager.queue_thread([] {
+            read_own_writes();
+            savepoints();
+        });
+        manager.run();
+    }
+
+    large_transfers(gv1_domain);
+    large_transfers(etl_domain);
+
+    return test_result();
+}
@@ -0,0 +1,178 @@
+#include <lstm/lstm.hpp>
+#include <lstm/multi_version_var.hpp>
+
+#ifdef NDEBUG
+#undef NDEBUG
+#include "debug_alloc.hpp"
+#define NDEBUG
+#else
+#include "debug_alloc.hpp"
+#endif
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+#include <random>
+#include <thread>
+
+static constexpr int loop_count    = LSTM_TEST_INIT(100000, 1000);
+static constexpr int account_count = 64;
+static constexpr int initial       = 100;
+
+using mv_int = lstm::multi_version_var<int, debug_alloc<int>>;
+
+// commits to the vars from another thread while the calling thread is mid transaction. the commit
+// waits for the calling thread to start waiting on it, and the other thread waits on the grace
+// period of the calling thread before exiting, so it is only joined after the transaction is done
+template<typename Func>
+static void read_around_commit(lstm::transaction_domain& domain, mv_int& x, mv_int& y, Func func)
+{
+    std::atomic<bool> waiting{false};
+    std::atomic<bool> committed{false};
+    std::thread       writer{[&] {
+        while (!waiting.load(LSTM_ACQUIRE))
+            std::this_thread::yield();
+        lstm::atomic(domain, [&](const lstm::transaction tx) {
+            x.set(tx, x.get(tx) + 1);
+            y.set(tx, y.get(tx) + 1);
+        });
+        committed.store(true, LSTM_RELEASE);
+    }};
+    func([&] {
+        waiting.store(true, LSTM_RELEASE);
+        while (!committed.load(LSTM_ACQUIRE))
+            std::this_thread::yield();
+    });
+    writer.join();
+}
+
+static void read_history(lstm::transaction_domain& domain)
+{
+    mv_int x{0};
+    mv_int y{0};
+    int    attempts = 0;
+
+    read_around_commit(domain, x, y, [&](auto wait_for_commit) {
+        lstm::read_only(domain, [&](const lstm::read_transaction tx) {
+            ++attempts;
+            CHECK(x.get(tx) == 0);
+            wait_for_commit();
+            // both the var already read, and the var first read after the commit, are read as of
+            // the version of the transaction
+            CHECK(x.get(tx) == 0);
+            CHECK(y.get(tx) == 0);
+            CHECK(y.untracked_get(tx) == 0);
+        });
+    });
+    CHECK(attempts == 1);
+    CHECK(x.unsafe_get() == 1);
+    CHECK(y.unsafe_get() == 1);
+
+    // read write transactions only ever see the latest value
+    lstm::atomic(domain, [&](const lstm::transaction tx) {
+        CHECK(x.get(tx) == 1);
+        x.set(tx, 2);
+        CHECK(x.get(tx) == 2);
+        x.set(tx, x.get(tx) + 1);
+        lstm::read_only([&](const lstm::read_transaction rtx) { CHECK(x.get(rtx) == 3); });
+    });
+    CHECK(x.unsafe_get() == 3);
+}
+
+// readers scanning every account never retry, and always see the same total
+static void scan_accounts(lstm::transaction_domain& domain)
+{
+    mv_int           accounts[account_count]{};
+    std::atomic<int> reader_attempts{0};
+    thread_manager   manager;
+
+    for (auto& account : accounts)
+        account.unsafe_set(initial);
+
+    for (int t = 0; t < 2; ++t) {
+        manager.queue_thread([&, t] {
+            std::mt19937                       gen(t);
+            std::uniform_int_distribution<int> dist(0, account_count - 1);
+            for (int i = 0; i < loop_count; ++i) {
+                const int from = dist(gen);
+                const int to   = dist(gen);
+                lstm::atomic(domain, [&](const lstm::transaction tx) {
+                    accounts[from].set(tx, accounts[from].get(tx) - 1);
+                    accounts[to].set(tx, accounts[to].get(tx) + 1);
+                });
+            }
+        });
+    }
+    manager.queue_loop_n(
+        [&] {
+            lstm::read_only(domain, [&](const lstm::read_transaction tx) {
+                reader_attempts.fetch_add(1, LSTM_RELAXED);
+                int sum = 0;
+                for (auto& account : accounts)
+                    sum += account.get(tx);
+                CHECK(sum == account_count * initial);
+            });
+        },
+        loop_count / 10);
+
+    manager.run();
+
+    CHECK(reader_attempts.load(LSTM_RELAXED) == loop_count / 10);
+    int sum = 0;
+    for (auto& account : accounts)
+        sum += account.unsafe_get();
+    CHECK(sum == account_count * initial);
+}
+
+// multi version vars are written through the write set, even when mixed with vars that are locked
+// on their first write
+static void mixed_with_encounter_time_locking()
+{
+    lstm::transaction_domain domain{lstm::locking_mode::encounter_time};
+    lstm::var<int>           plain{0};
+    mv_int                   versioned{0};
+    thread_manager           manager;
+
+    for (int t = 0; t < 2; ++t) {
+        manager.queue_loop_n(
+            [&] {
+                lstm::atomic(domain, [&](const lstm::transaction tx) {
+                    plain.set(tx, plain.get(tx) + 1);
+                    versioned.set(tx, versioned.get(tx) + 1);
+                });
+            },
+            loop_count);
+    }
+    manager.queue_loop_n(
+        [&] {
+            lstm::read_only(domain, [&](const lstm::read_transaction tx) {
+                CHECK(versioned.get(tx) == plain.get(tx));
+            });
+        },
+        loop_count);
+
+    manager.run();
+
+    CHECK(plain.unsafe_get() == loop_count * 2);
+    CHECK(versioned.unsafe_get() == loop_count * 2);
+}
+
+int main()
+{
+    {
+        lstm::transaction_domain                        domain;
+        lstm::basic_transaction_domain<lstm::gv5_clock> gv5_domain;
+        // on their own threads, so that thread exit reclaims everything they freed
+        {
+            thread_manager manager;
+            manager.queue_thread([&] { read_history(domain); });
+            manager.queue_thread([&] { read_history(gv5_domain); });
+            manager.run();
+        }
+        scan_accounts(domain);
+        scan_accounts(gv5_domain);
+        mixed_with_encounter_time_locking();
+    }
+    CHECK(debug_live_allocations<> == 0);
+
+    return test_result();
+}
@@ -0,0 +1,123 @@
+#ifndef LSTM_NO_EXCEPTIONS
+#define LSTM_NO_EXCEPTIONS
+#endif
+#include <lstm/lstm.hpp>
+
+#include "contention_helpers.hpp"
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+static constexpr int loop_count    = LSTM_TEST_INIT(50000, 500);
+static constexpr int thread_count  = 4;
+static constexpr int account_count = 4;
+
+// aborts restart the transaction, with everything it wrote discarded
+static void restarts()
+{
+    lstm::var<int> x{0};
+    lstm::var<int> y{0};
+    int            attempts = 0;
+    lstm::atomic([&](const lstm::transaction tx) {
+        ++attempts;
+        y.set(tx, x.get(tx) + 1);
+        if (attempts < 3)
+            add_on_other_thread(x, 1);
+    });
+    CHECK(attempts == 3);
+    CHECK(y.unsafe_get() == 3);
+
+    attempts         = 0;
+    const int result = lstm::atomic([&](const lstm::read_transaction tx) {
+        if (++attempts < 3)
+            lstm::retry();
+        return x.get(tx);
+    });
+    CHECK(attempts == 3);
+    CHECK(result == 2);
+}
+
+// lstm::retry reaches the innermost or_else, and other aborts pass through it
+static void alternatives()
+{
+    lstm::var<int> x{0};
+    lstm::var<int> y{0};
+    lstm::var<int> z{0};
+    lstm::var<int> w{0};
+    int            attempts = 0;
+    lstm::atomic([&](const lstm::transaction tx) {
+        ++attempts;
+        const int value = lstm::or_else(tx,
+                                         [&] {
+                                             y.set(tx, 10);
+                                             return lstm::or_else(tx,
+                                                                  [&]() -> int {
+                                                                      y.set(tx, 20);
+                                                                      lstm::retry();
+                                                                  },
+                                                                  [&] { return y.get(tx); });
+                                         },
+                                         [&] { return -1; });
+        if (attempts == 1) {
+            lstm::or_else(tx,
+                          [&] {
+                              z.get(tx);
+                              add_on_other_thread(z, 1);
+                              add_on_other_thread(w, 1);
+                              w.get(tx);
+                          },
+                          [&] { CHECK(false); });
+        }
+        x.set(tx, value);
+    });
+    CHECK(attempts == 2);
+    CHECK(x.unsafe_get() == 10);
+    CHECK(y.unsafe_get() == 10);
+}
+
+// every transfer commits exactly once
+static void transfers()
+{
+    lstm::var<int> accounts[account_count];
+    thread_manager manager;
+
+    for (int i = 0; i < thread_count; ++i) {
+        manager.queue_loop_n(
+            [&, i] {
+                lstm::atomic([&](const lstm::transaction tx) {
+                    lstm::var<int>& from = accounts[i % account_count];
+                    lstm::var<int>& to   = accounts[(i + 1) % account_count];
+                    from.set(tx, from.get(tx) - 1);
+                    to.set(tx, to.get(tx) + 1);
+                });
+                lstm::atomic([&](const lstm::read_transaction tx) {
+                    int total = 0;
+                    for (auto& account : accounts)
+                        total += account.get(tx);
+                    CHECK(total == 0);
+                });
+            },
+            loop_count);
+    }
+
+    manager.run();
+
+    int total = 0;
+    for (auto& account : accounts)
+        total += account.unsafe_get();
+    CHECK(total == 0);
+}
+
+int main()
+{
+    {
+        thread_manager manager;
+        manager.queue_thread([] {
+            restarts();
+            alternatives();
+        });
+        manager.run();
+    }
+    transfers();
+
+    return test_result();
+}
@@ -0,0 +1,141 @@
+#define LSTM_NOREC
+#include <lstm/lstm.hpp>
+
+#ifdef NDEBUG
+#undef NDEBUG
+#include "debug_alloc.hpp"
+#define NDEBUG
+#else
+#include "debug_alloc.hpp"
+#endif
+#include "contention_helpers.hpp"
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+static constexpr int loop_count = LSTM_TEST_INIT(100000, 1000);
+static constexpr int account_count = 8;
+
+using pair_var = lstm::var<std::pair<int, int>, debug_alloc<std::pair<int, int>>>;
+
+static_assert(sizeof(lstm::var<int>) == sizeof(void*), "");
+static_assert(sizeof(lstm::var<void*>) == sizeof(void*), "");
+
+// commits that leave everything read unchanged extend the snapshot instead of retrying
+static void extension()
+{
+    lstm::var<int> x{0};
+    lstm::var<int> y{0};
+    int            attempts = 0;
+    lstm::atomic([&](const lstm::transaction tx) {
+        ++attempts;
+        x.set(tx, x.get(tx) + 1);
+        if (attempts == 1) {
+            commit_on_other_thread(y, 42);
+            // the value is all that is validated, so a var written back to what was read is fine
+            commit_on_other_thread(x, 1);
+            commit_on_other_thread(x, 0);
+        }
+        CHECK(y.get(tx) == 42);
+    });
+    CHECK(attempts == 1);
+    CHECK(x.unsafe_get() == 1);
+}
+
+// a changed value forces a retry, whether it was found on a later read or at commit
+static void retry()
+{
+    {
+        lstm::var<int> x{0};
+        lstm::var<int> y{0};
+        int            attempts = 0;
+        lstm::atomic([&](const lstm::transaction tx) {
+            ++attempts;
+            const int x_ = x.get(tx);
+            if (attempts == 1) {
+                commit_on_other_thread(x, 42);
+                commit_on_other_thread(y, 42);
+            }
+            y.get(tx);
+            CHECK(x_ == 42);
+        });
+        CHECK(attempts == 2);
+    }
+    {
+        lstm::var<int> x{0};
+        lstm::var<int> y{0};
+        int            attempts = 0;
+        lstm::atomic([&](const lstm::transaction tx) {
+            ++attempts;
+            y.set(tx, x.get(tx) + 1);
+            if (attempts == 1)
+                commit_on_other_thread(x, 42);
+        });
+        CHECK(attempts == 2);
+        CHECK(y.unsafe_get() == 43);
+    }
+}
+
+// transfers keep the total constant, and no reader ever sees it otherwise
+static void transfers()
+{
+    lstm::var<int> accounts[account_count]{};
+    pair_var       pair{0, 0};
+    thread_manager manager;
+
+    for (int i = 0; i < 4; ++i) {
+        manager.queue_loop_n(
+            [&, i] {
+                lstm::atomic([&](const lstm::transaction tx) {
+                    lstm::var<int>& from = accounts[i % account_count];
+                    lstm::var<int>& to   = accounts[(i * 3 + 1) % account_count];
+                    from.set(tx, from.get(tx) - 1);
+                    to.set(tx, to.get(tx) + 1);
+
+                    const auto p = pair.get(tx);
+                    pair.set(tx, {p.first + 1, p.second - 1});
+                });
+            },
+            loop_count);
+    }
+    for (int i = 0; i < 2; ++i) {
+        manager.queue_loop_n(
+            [&] {
+                lstm::read_only([&](const lstm::read_transaction tx) {
+                    int sum = 0;
+                    for (auto& account : accounts)
+                        sum += account.get(tx);
+                    CHECK(sum == 0);
+                    const auto p = pair.get(tx);
+                    const int total = p.first + p.second;
+                    CHECK(total == 0);
+                });
+            },
+            loop_count);
+    }
+
+    manager.run();
+
+    int sum = 0;
+    for (auto& account : accounts)
+        sum += account.unsafe_get();
+    CHECK(sum == 0);
+    CHECK(pair.unsafe_get() == std::make_pair(4 * loop_count, -4 * loop_count));
+}
+
+int main()
+{
+    {
+        thread_manager manager;
+        manager.queue_thread([] {
+            extension();
+            retry();
+        });
+        manager.run();
+    }
+
+    transfers();
+
+    CHECK(debug_live_allocations<> == 0);
+
+    return test_result();
+}
@@ -0,0 +1,155 @@
+#include <lstm/lstm.hpp>
+
+#ifdef NDEBUG
+#undef NDEBUG
+#include "debug_alloc.hpp"
+#define NDEBUG
+#else
+#include "debug_alloc.hpp"
+#endif
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+static constexpr int loop_count   = LSTM_TEST_INIT(20000, 200);
+static constexpr int thread_count = 4;
+
+using pair_var = lstm::var<std::pair<int, int>, debug_alloc<std::pair<int, int>>>;
+
+static lstm::transaction_domain gv1_domain{};
+static lstm::transaction_domain etl_domain{lstm::locking_mode::encounter_time};
+static lstm::transaction_domain combining_domain{lstm::locking_mode::commit_time,
+                                                 lstm::commit_mode::combining};
+
+// open nested transactions commit before the transaction they are nested in does
+static void commits_first(lstm::transaction_domain& domain)
+{
+    lstm::var<int> counter{0};
+    lstm::var<int> x{0};
+    lstm::atomic(domain, [&](const lstm::transaction tx) {
+        x.set(tx, 1);
+        const int id = lstm::open_nested(tx, [&](const lstm::transaction tx) {
+            const int result = counter.get(tx);
+            counter.set(tx, result + 1);
+            return result;
+        });
+        CHECK(id == 0);
+        CHECK(counter.unsafe_get() == 1);
+        CHECK(x.get(tx) == 1);
+    });
+    CHECK(x.unsafe_get() == 1);
+    CHECK(counter.unsafe_get() == 1);
+}
+
+// compensations undo the open nested transactions of failed attempts
+static void compensates(lstm::transaction_domain& domain)
+{
+    lstm::var<int> counter{0};
+    int            attempts = 0;
+    lstm::atomic(domain, [&](const lstm::transaction tx) {
+        lstm::open_nested(tx,
+                          [&](const lstm::transaction tx) { counter.set(tx, counter.get(tx) + 1); },
+                          [&counter](const lstm::transaction tx) {
+                              counter.set(tx, counter.get(tx) - 1);
+                          });
+        if (++attempts < 3)
+            lstm::retry();
+    });
+    CHECK(attempts == 3);
+    CHECK(counter.unsafe_get() == 1);
+
+    try {
+        lstm::atomic(domain, [&](const lstm::transaction tx) {
+            lstm::open_nested(tx,
+                              [&](const lstm::transaction tx) {
+                                  counter.set(tx, counter.get(tx) + 1);
+                              },
+                              [&counter](const lstm::transaction tx) {
+                                  counter.set(tx, counter.get(tx) - 1);
+                              });
+            throw 0;
+        });
+    } catch (int) {
+    }
+    CHECK(counter.unsafe_get() == 1);
+}
+
+// an irrevocable transaction does not block the open nested transactions it runs
+static void irrevocable(lstm::transaction_domain& domain)
+{
+    lstm::var<int> counter{0};
+    lstm::atomic(domain, lstm::irrevocable([&](const lstm::transaction tx) {
+                     lstm::open_nested(tx, [&](const lstm::transaction tx) {
+                         counter.set(tx, counter.get(tx) + 1);
+                     });
+                 }));
+    CHECK(counter.unsafe_get() == 1);
+}
+
+// the storage replaced by many open nested commits is reclaimed without waiting on the transaction
+// they are nested in
+static void reclaims(lstm::transaction_domain& domain)
+{
+    pair_var p{0, 0};
+    lstm::atomic(domain, [&](const lstm::transaction tx) {
+        for (int i = 0; i < 1000; ++i) {
+            lstm::open_nested(tx, [&](const lstm::transaction tx) {
+                const auto p_ = p.get(tx);
+                p.set(tx, {p_.first + 1, p_.second - 1});
+            });
+        }
+    });
+    CHECK(p.unsafe_get() == std::make_pair(1000, -1000));
+}
+
+// every transaction bumps a shared counter, but only conflicts on vars of its own
+static void shared_counter(lstm::transaction_domain& domain)
+{
+    lstm::var<int> accounts[thread_count]{};
+    lstm::var<int> counter{0};
+    int            attempts[thread_count]{};
+    thread_manager manager;
+
+    for (int i = 0; i < thread_count; ++i) {
+        manager.queue_loop_n(
+            [&, i] {
+                lstm::atomic(domain, [&](const lstm::transaction tx) {
+                    ++attempts[i];
+                    accounts[i].set(tx, accounts[i].get(tx) + 1);
+                    lstm::open_nested(tx, [&](const lstm::transaction tx) {
+                        counter.set(tx, counter.get(tx) + 1);
+                    });
+                });
+            },
+            loop_count);
+    }
+
+    manager.run();
+
+    for (int i = 0; i < thread_count; ++i) {
+        CHECK(attempts[i] == loop_count);
+        CHECK(accounts[i].unsafe_get() == loop_count);
+    }
+    CHECK(counter.unsafe_get() == thread_count * loop_count);
+}
+
+int main()
+{
+    for (lstm::transaction_domain* domain : {&gv1_domain, &etl_domain, &combining_domain}) {
+        {
+            thread_manager manager;
+            manager.queue_thread([domain] {
+                commits_first(*domain);
+                compensates(*domain);
+                irrevocable(*domain);
+                reclaims(*domain);
+            });
+            manager.run();
+        }
+
+        shared_counter(*domain);
+    }
+
+    CHECK(debug_live_allocations<> == 0);
+
+    return test_result();
+}
@@ -0,0 +1,188 @@
+#include <lstm/lstm.hpp>
+#include <lstm/multi_version_var.hpp>
+
+#ifdef NDEBUG
+#undef NDEBUG
+#include "debug_alloc.hpp"
+#define NDEBUG
+#else
+#include "debug_alloc.hpp"
+#endif
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+static constexpr int loop_count = LSTM_TEST_INIT(20000, 200);
+
+using pair_var = lstm::var<std::pair<int, int>, debug_alloc<std::pair<int, int>>>;
+using mv_var   = lstm::multi_version_var<int, debug_alloc<int>>;
+
+static lstm::transaction_domain gv1_domain{};
+static lstm::transaction_domain etl_domain{lstm::locking_mode::encounter_time};
+static lstm::transaction_domain combining_domain{lstm::locking_mode::commit_time,
+                                                 lstm::commit_mode::combining};
+
+// the writes of the first alternative are undone before the second runs, whether they replaced
+// writes made before the savepoint or not
+static void rolls_back(lstm::transaction_domain& domain)
+{
+    pair_var       p{0, 0};
+    pair_var       q{0, 0};
+    lstm::var<int> x{0};
+    mv_var         mv{0};
+
+    const int result = lstm::atomic(domain, [&](const lstm::transaction tx) {
+        p.set(tx, {1, -1});
+        x.set(tx, 1);
+        return lstm::or_else(tx,
+                             [&] {
+                                 p.set(tx, {2, -2});
+                                 p.set(tx, {3, -3});
+                                 q.set(tx, {2, -2});
+                                 x.set(tx, 2);
+                                 mv.set(tx, 2);
+                                 lstm::retry();
+                                 return 0;
+                             },
+                             [&] {
+                                 CHECK(p.get(tx) == std::make_pair(1, -1));
+                                 CHECK(q.get(tx) == std::make_pair(0, 0));
+                                 CHECK(x.get(tx) == 1);
+                                 CHECK(mv.get(tx) == 0);
+                                 q.set(tx, {4, -4});
+                                 return 42;
+                             });
+    });
+
+    CHECK(result == 42);
+    CHECK(p.unsafe_get() == std::make_pair(1, -1));
+    CHECK(q.unsafe_get() == std::make_pair(4, -4));
+    CHECK(x.unsafe_get() == 1);
+    CHECK(mv.unsafe_get() == 0);
+}
+
+// a savepoint that is not restored keeps the writes of the first alternative, unless an enclosing
+// savepoint is restored
+static void nested(lstm::transaction_domain& domain)
+{
+    pair_var p{0, 0};
+    int      second_runs = 0;
+
+    lstm::atomic(domain, [&](const lstm::transaction tx) {
+        p.set(tx, {1, -1});
+        lstm::or_else(tx,
+                      [&] {
+                          lstm::or_else(tx,
+                                        [&] { p.set(tx, {2, -2}); },
+                                        [&] { CHECK(false); });
+                          CHECK(p.get(tx) == std::make_pair(2, -2));
+                          lstm::or_else(tx,
+                                        [&] {
+                                            p.set(tx, {3, -3});
+                                            lstm::retry();
+                                        },
+                                        [&] {
+                                            CHECK(p.get(tx) == std::make_pair(2, -2));
+                                            lstm::retry();
+                                        });
+                      },
+                      [&] {
+                          ++second_runs;
+                          CHECK(p.get(tx) == std::make_pair(1, -1));
+                      });
+    });
+
+    CHECK(second_runs == 1);
+    CHECK(p.unsafe_get() == std::make_pair(1, -1));
+}
+
+// exceptions other than lstm::retry fail the whole transaction
+static void exceptions(lstm::transaction_domain& domain)
+{
+    pair_var p{0, 0};
+    try {
+        lstm::atomic(domain, [&](const lstm::transaction tx) {
+            p.set(tx, {1, -1});
+            lstm::or_else(tx, [&] { throw 0; }, [&] { CHECK(false); });
+        });
+    } catch (int) {
+    }
+    CHECK(p.unsafe_get() == std::make_pair(0, 0));
+}
+
+static void read_only()
+{
+    lstm::var<int> x{0};
+    const int      result = lstm::atomic([&](const lstm::read_transaction tx) {
+        return lstm::or_else(tx,
+                             [&] {
+                                 if (!x.get(tx))
+                                     lstm::retry();
+                                 return 1;
+                             },
+                             [&] { return 2; });
+    });
+    CHECK(result == 2);
+}
+
+// consumers take from whichever of two queues has items, and block when neither has any
+static void either_queue(lstm::transaction_domain& domain)
+{
+    lstm::var<int> queues[2]{};
+    lstm::var<int> taken[2]{};
+    thread_manager manager;
+
+    for (int i = 0; i < 2; ++i) {
+        manager.queue_loop_n(
+            [&, i] {
+                lstm::atomic(domain, [&](const lstm::transaction tx) {
+                    queues[i].set(tx, queues[i].get(tx) + 1);
+                });
+            },
+            loop_count);
+        manager.queue_loop_n(
+            [&] {
+                const auto take = [&](const lstm::transaction tx, const int queue) {
+                    const int size = queues[queue].get(tx);
+                    queues[queue].set(tx, size - 1);
+                    taken[queue].set(tx, taken[queue].get(tx) + 1);
+                    if (!size)
+                        lstm::retry();
+                };
+                lstm::atomic(domain, [&](const lstm::transaction tx) {
+                    lstm::or_else(tx, [&] { take(tx, 0); }, [&] { take(tx, 1); });
+                });
+            },
+            loop_count);
+    }
+
+    manager.run();
+
+    CHECK(queues[0].unsafe_get() == 0);
+    CHECK(queues[1].unsafe_get() == 0);
+    CHECK(taken[0].unsafe_get() == loop_count);
+    CHECK(taken[1].unsafe_get() == loop_count);
+}
+
+int main()
+{
+    for (lstm::transaction_domain* domain : {&gv1_domain, &etl_domain, &combining_domain}) {
+        thread_manager manager;
+        manager.queue_thread([domain] {
+            rolls_back(*domain);
+            nested(*domain);
+            exceptions(*domain);
+        });
+        manager.run();
+
+        either_queue(*domain);
+    }
+    {
+        thread_manager manager;
+        manager.queue_thread(read_only);
+        manager.run();
+    }
+
+    CHECK(debug_live_allocations<> == 0);
+
+    return test_result();
+}
@@ -0,0 +1,90 @@
+#define LSTM_READ_SET_CACHE 64
+#include <lstm/lstm.hpp>
+
+#include "contention_helpers.hpp"
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+static constexpr int loop_count   = LSTM_TEST_INIT(20000, 200);
+static constexpr int thread_count = 4;
+static constexpr int var_count    = 16;
+
+// rereads do not grow the read set, yet every distinct var is still validated
+static void rereads()
+{
+    lstm::var<int> vars[var_count]{};
+    int            attempts = 0;
+    lstm::atomic(lstm::with_contention_manager<recording_manager>([&](const lstm::transaction tx) {
+        ++attempts;
+        for (int i = 0; i < 10; ++i) {
+            for (lstm::var<int>& v : vars)
+                v.get(tx);
+        }
+        if (attempts == 1) {
+            commit_on_other_thread(vars[0]);
+            vars[0].get(tx);
+        }
+    }));
+    CHECK(attempts == 2);
+    CHECK(recording_manager::last_info().reason == lstm::abort_reason::conflict);
+    CHECK(recording_manager::last_info().reads == std::size_t(var_count));
+}
+
+// rereads of a var after the cache has forgotten it only cost another read set entry
+static void evictions()
+{
+    std::vector<lstm::var<int>> vars(1000);
+    const int sum = lstm::atomic([&](const lstm::transaction tx) {
+        int result = 0;
+        for (int i = 0; i < 3; ++i) {
+            for (lstm::var<int>& v : vars)
+                result += v.get(tx) + 1;
+        }
+        return result;
+    });
+    CHECK(sum == 3000);
+}
+
+// every transaction rereads the neighbours of the vars it moves units between
+static void transfers()
+{
+    lstm::var<int> vars[var_count]{};
+    thread_manager manager;
+
+    for (int i = 0; i < thread_count; ++i) {
+        manager.queue_loop_n(
+            [&, i] {
+                lstm::atomic([&](const lstm::transaction tx) {
+                    const int from = (i * 3) % var_count;
+                    const int to   = (from + 1) % var_count;
+                    for (int j = 0; j < var_count; ++j)
+                        vars[j].get(tx);
+                    vars[from].set(tx, vars[from].get(tx) - 1);
+                    vars[to].set(tx, vars[to].get(tx) + 1);
+                });
+            },
+            loop_count);
+    }
+
+    manager.run();
+
+    int sum = 0;
+    for (lstm::var<int>& v : vars)
+        sum += v.unsafe_get();
+    CHECK(sum == 0);
+}
+
+int main()
+{
+    {
+        thread_manager manager;
+        manager.queue_thread([] {
+            rereads();
+            evictions();
+        });
+        manager.run();
+    }
+    transfers();
+
+    return test_result();
+}
@@ -0,0 +1,168 @@
+#include <lstm/easy_var.hpp>
+
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+static constexpr int loop_count   = LSTM_TEST_INIT(50000, 500);
+static constexpr int thread_count = 4;
+
+#ifndef LSTM_NOREC
+static lstm::transaction_domain etl_domain{lstm::locking_mode::encounter_time};
+#endif
+
+struct oops
+{
+};
+
+static void operations()
+{
+    lstm::transaction_domain& domain = lstm::default_domain();
+    lstm::var<int>            x{1};
+    CHECK(lstm::atomic_update(domain, x, [](const int value) { return value + 2; }) == 1);
+    CHECK(x.unsafe_get() == 3);
+    CHECK(lstm::exchange(domain, x, 5) == 3);
+
+    int expected = 4;
+    CHECK(!lstm::compare_exchange(domain, x, expected, 6));
+    CHECK(expected == 5);
+    CHECK(lstm::compare_exchange(domain, x, expected, 6));
+    CHECK(x.unsafe_get() == 6);
+
+    // the value need not be of the same type as the var
+    lstm::var<long> y{0};
+    CHECK(lstm::exchange(domain, y, 1) == 0);
+
+    // vars too large to update in place take a full transaction
+    lstm::var<std::string> s{"a"};
+    CHECK(lstm::atomic_update(domain, s, [](const std::string& value) { return value + "b"; })
+          == "a");
+    std::string expected_s = "ab";
+    CHECK(lstm::compare_exchange(domain, s, expected_s, "c"));
+    CHECK(lstm::exchange(domain, s, "d") == "c");
+    CHECK(s.unsafe_get() == "d");
+}
+
+// inside a transaction, the operations join it
+static void nested()
+{
+    lstm::transaction_domain& domain = lstm::default_domain();
+    lstm::var<int>            x{0};
+    try {
+        lstm::atomic([&](const lstm::transaction tx) {
+            lstm::atomic_update(domain, x, [](const int value) { return value + 1; });
+            CHECK(x.get(tx) == 1);
+            int expected = 1;
+            CHECK(lstm::compare_exchange(domain, x, expected, 2));
+            CHECK(x.get(tx) == 2);
+            throw oops{};
+        });
+    } catch (const oops&) {
+    }
+    CHECK(x.unsafe_get() == 0);
+}
+
+// a thread blocked in lstm::retry is woken by a single var commit
+static void wakes()
+{
+    lstm::var<int> ready{0};
+    std::thread    consumer{[&] {
+        lstm::atomic([&](const lstm::transaction tx) {
+            if (!ready.get(tx))
+                lstm::retry();
+        });
+    }};
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    lstm::exchange(lstm::default_domain(), ready, 1);
+    consumer.join();
+}
+
+// single var updates race transactions that move units between the same vars
+static void counts(lstm::transaction_domain& domain)
+{
+    lstm::easy_var<int> counter{0};
+    lstm::var<int>      x{0};
+    lstm::var<int>      y{0};
+    thread_manager      manager;
+
+    for (int i = 0; i < thread_count; ++i) {
+        manager.queue_loop_n(
+            [&, i] {
+                switch (i) {
+                case 0:
+                    ++counter;
+                    break;
+                case 1:
+                    counter += 2;
+                    break;
+                case 2:
+                    lstm::atomic_update(domain, x, [](const int value) { return value + 1; });
+                    break;
+                default:
+                    lstm::atomic(domain, [&](const lstm::transaction tx) {
+                        x.set(tx, x.get(tx) - 1);
+                        y.set(tx, y.get(tx) + 1);
+                    });
+                    int expected = 0;
+                    while (!lstm::compare_exchange(domain, y, expected, expected - 1)) {
+                    }
+                    break;
+                }
+            },
+            loop_count);
+    }
+
+    manager.run();
+
+    CHECK(counter.get() == 3 * loop_count);
+    CHECK(x.unsafe_get() == 0);
+    CHECK(y.unsafe_get() == 0);
+}
+
+// a var of another domain is updated alongside transactions in that domain, leaving the default
+// domain untouched
+static void other_domain()
+{
+    lstm::transaction_domain domain;
+    lstm::var<int>           x{0};
+    thread_manager           manager;
+
+    const lstm::epoch_t default_clock = lstm::default_domain().get_clock();
+    manager.queue_loop_n(
+        [&] { lstm::atomic_update(domain, x, [](const int value) { return value + 1; }); },
+        loop_count);
+    manager.queue_loop_n(
+        [&] {
+            lstm::atomic(domain, [&](const lstm::transaction tx) { x.set(tx, x.get(tx) + 1); });
+        },
+        loop_count);
+    manager.run();
+
+    CHECK(x.unsafe_get() == loop_count * 2);
+    CHECK(domain.get_clock() == lstm::epoch_t(loop_count * 2));
+    CHECK(lstm::default_domain().get_clock() == default_clock);
+}
+
+int main()
+{
+    {
+        thread_manager manager;
+        manager.queue_thread([] {
+            operations();
+            nested();
+        });
+        manager.run();
+    }
+    wakes();
+    counts(lstm::default_domain());
+#ifndef LSTM_NOREC
+    counts(etl_domain);
+#endif
+    other_domain();
+
+    return test_result();
+}
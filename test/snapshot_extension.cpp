@@ -0,0 +1,143 @@
+#include <lstm/lstm.hpp>
+
+#include "contention_helpers.hpp"
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+static constexpr int loop_count = LSTM_TEST_INIT(100000, 1000);
+
+int main()
+{
+    // a var written after the transaction began, that is unrelated to anything read, extends the
+    // snapshot instead of retrying
+    {
+        lstm::var<int> x{0};
+        lstm::var<int> y{0};
+        int            attempts = 0;
+        lstm::atomic([&](const lstm::transaction tx) {
+            ++attempts;
+            const auto version = tx.version();
+            CHECK(x.get(tx) == 0);
+            if (attempts == 1)
+                commit_on_other_thread(y);
+            CHECK(y.get(tx) == 42);
+            CHECK(tx.version() > version);
+        });
+        CHECK(attempts == 1);
+    }
+
+    // copies of the transaction share the extended snapshot
+    {
+        lstm::var<int> x{0};
+        lstm::var<int> y{0};
+        int            attempts = 0;
+        lstm::atomic([&](const lstm::transaction tx) {
+            ++attempts;
+            const lstm::transaction tx_copy = tx;
+            x.set(tx, 1);
+            if (attempts == 1)
+                commit_on_other_thread(y);
+            lstm::read_only([&](const lstm::read_transaction rtx) { CHECK(y.get(rtx) == 42); });
+            CHECK(tx_copy.version() == tx.version());
+            CHECK(y.get(tx_copy) == 42);
+        });
+        CHECK(attempts == 1);
+        CHECK(x.unsafe_get() == 1);
+    }
+
+    // if something already read has changed, extension fails, and the transaction retries
+    {
+        lstm::var<int> x{0};
+        lstm::var<int> y{0};
+        int            attempts = 0;
+        lstm::atomic([&](const lstm::transaction tx) {
+            ++attempts;
+            const int x_ = x.get(tx);
+            if (attempts == 1) {
+                commit_on_other_thread(x);
+                commit_on_other_thread(y);
+            }
+            y.get(tx);
+            CHECK(x_ == 42);
+        });
+        CHECK(attempts == 2);
+    }
+
+    // the same goes for something already written
+    {
+        lstm::var<int> x{0};
+        lstm::var<int> y{0};
+        int            attempts = 0;
+        lstm::atomic([&](const lstm::transaction tx) {
+            ++attempts;
+            x.set(tx, 1);
+            if (attempts == 1) {
+                commit_on_other_thread(x);
+                commit_on_other_thread(y);
+            }
+            y.get(tx);
+        });
+        CHECK(attempts == 2);
+        CHECK(x.unsafe_get() == 1);
+    }
+
+    // untracked reads, and reads through a demoted transaction, are never revalidated, so a
+    // transaction that made any cannot be extended
+    {
+        lstm::var<int> x{0};
+        lstm::var<int> y{0};
+        int            attempts = 0;
+        lstm::atomic([&](const lstm::transaction tx) {
+            ++attempts;
+            x.untracked_get(tx);
+            if (attempts == 1)
+                commit_on_other_thread(y);
+            CHECK(y.get(tx) == 42);
+        });
+        CHECK(attempts == 2);
+    }
+    {
+        lstm::var<int> x{0};
+        lstm::var<int> y{0};
+        int            attempts = 0;
+        lstm::atomic([&](const lstm::transaction tx) {
+            ++attempts;
+            x.get(tx.unsafe_checked_demote());
+            if (attempts == 1)
+                commit_on_other_thread(y);
+            CHECK(y.get(tx) == 42);
+        });
+        CHECK(attempts == 2);
+    }
+
+    // long readers keep making progress while writers commit to unrelated vars
+    {
+        lstm::var<int> read_vars[16]{};
+        lstm::var<int> written{0};
+        thread_manager manager;
+
+        manager.queue_loop_n(
+            [&] {
+                lstm::atomic([&](const lstm::transaction tx) {
+                    int sum = 0;
+                    for (auto& v : read_vars)
+                        sum += v.get(tx);
+                    CHECK(sum == 0);
+                    written.get(tx);
+                });
+            },
+            loop_count);
+        manager.queue_loop_n(
+            [&] {
+                lstm::atomic([&](const lstm::transaction tx) {
+                    written.set(tx, written.get(tx) + 1);
+                });
+            },
+            loop_count);
+
+        manager.run();
+        CHECK(written.unsafe_get() == loop_count);
+    }
+
+    return test_result();
+}
@@ -0,0 +1,108 @@
+#include <lstm/lstm.hpp>
+
+#include "contention_helpers.hpp"
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+static constexpr int loop_count = LSTM_TEST_INIT(100000, 1000);
+
+int main()
+{
+    // vars that are only read may change before commit. a read write transaction would retry
+    {
+        lstm::var<int> x{0};
+        lstm::var<int> y{0};
+        int            attempts = 0;
+        lstm::snapshot_isolated([&](const lstm::transaction tx) {
+            ++attempts;
+            const int x_ = x.get(tx);
+            if (attempts == 1)
+                commit_on_other_thread(x);
+            y.set(tx, x_ + 1);
+        });
+        CHECK(attempts == 1);
+        CHECK(x.unsafe_get() == 42);
+        CHECK(y.unsafe_get() == 1);
+    }
+
+    // the first committer wins on vars written by both
+    {
+        lstm::var<int> x{0};
+        int            attempts = 0;
+        lstm::snapshot_isolated([&](const lstm::transaction tx) {
+            ++attempts;
+            const int x_ = x.get(tx);
+            if (attempts == 1)
+                commit_on_other_thread(x);
+            x.set(tx, x_ + 1);
+        });
+        CHECK(attempts == 2);
+        CHECK(x.unsafe_get() == 43);
+    }
+
+    // every read comes from the same snapshot, so newer vars are never extended past
+    {
+        lstm::var<int> x{0};
+        lstm::var<int> y{0};
+        int            attempts = 0;
+        lstm::snapshot_isolated([&](const lstm::transaction tx) {
+            ++attempts;
+            x.get(tx);
+            if (attempts == 1)
+                commit_on_other_thread(y);
+            CHECK(y.get(tx) == 42);
+        });
+        CHECK(attempts == 2);
+    }
+
+    // nested transactions merge into a snapshot isolated transaction, and the transaction after it
+    // is serializable again
+    {
+        lstm::var<int> x{0};
+        lstm::var<int> y{0};
+        int            attempts = 0;
+        lstm::snapshot_isolated([&](const lstm::transaction) {
+            lstm::atomic([&](const lstm::transaction tx) {
+                ++attempts;
+                const int x_ = x.get(tx);
+                if (attempts == 1)
+                    commit_on_other_thread(x);
+                y.set(tx, x_ + 1);
+            });
+        });
+        CHECK(attempts == 1);
+        CHECK(!lstm::tls_thread_data().snapshot_isolated());
+
+        attempts = 0;
+        lstm::atomic([&](const lstm::transaction tx) {
+            ++attempts;
+            const int y_ = y.get(tx);
+            if (attempts == 1)
+                commit_on_other_thread(y);
+            x.set(tx, y_ + 1);
+        });
+        CHECK(attempts == 2);
+        CHECK(x.unsafe_get() == 43);
+    }
+
+    // counters lose no increments
+    {
+        lstm::var<int> counter{0};
+        thread_manager manager;
+
+        for (int i = 0; i < 4; ++i) {
+            manager.queue_loop_n(
+                [&] {
+                    lstm::snapshot_isolated([&](const lstm::transaction tx) {
+                        counter.set(tx, counter.get(tx) + 1);
+                    });
+                },
+                loop_count);
+        }
+
+        manager.run();
+        CHECK(counter.unsafe_get() == 4 * loop_count);
+    }
+
+    return test_result();
+}
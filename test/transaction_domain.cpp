@@ -0,0 +1,121 @@
+#include <lstm/containers/list.hpp>
+
+#ifdef NDEBUG
+#undef NDEBUG
+#include "debug_alloc.hpp"
+#define NDEBUG
+#else
+#include "debug_alloc.hpp"
+#endif
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+static constexpr int loop_count   = LSTM_TEST_INIT(200000, 2000);
+static constexpr int domain_count = 100;
+
+using counter_t = lstm::var<std::pair<int, int>, debug_alloc<std::pair<int, int>>>;
+
+static lstm::transaction_domain domain0;
+static lstm::transaction_domain domain1;
+
+void increment(lstm::transaction_domain& domain, counter_t& counter)
+{
+    lstm::atomic(domain, [&](const lstm::transaction tx) {
+        CHECK(&tx.domain() == &domain);
+        auto value = counter.get(tx);
+        ++value.first;
+        // nested transactions join the domain of the rootmost transaction
+        lstm::atomic([&](const lstm::transaction nested_tx) {
+            CHECK(&nested_tx.domain() == &domain);
+            ++value.second;
+            counter.set(nested_tx, value);
+        });
+    });
+}
+
+// a thread that outlives a domain still has frees queued for it. they are reclaimed without using
+// the domain, even after another domain takes its place in memory
+static void destroyed_domain()
+{
+    using storage_t = std::aligned_storage_t<sizeof(lstm::transaction_domain),
+                                             alignof(lstm::transaction_domain)>;
+    storage_t      storage;
+    thread_manager manager;
+
+    manager.queue_thread([&] {
+        for (int i = 0; i < domain_count; ++i) {
+            lstm::transaction_domain* const domain
+                = ::new (&storage) lstm::transaction_domain{lstm::gv5_clock{}};
+            {
+                counter_t counter{0, 0};
+                lstm::atomic(*domain, [&](const lstm::transaction tx) {
+                    counter.set(tx, std::make_pair(i, i));
+                });
+            }
+            domain->~transaction_domain();
+            // any later use of the domain calls through a garbage clock policy
+            std::memset(&storage, 0xff, sizeof(storage));
+        }
+
+        // enough frees to reclaim everything queued before
+        counter_t counter{0, 0};
+        for (int i = 0; i < 2048; ++i) {
+            lstm::atomic([&](const lstm::transaction tx) {
+                counter.set(tx, std::make_pair(i, i));
+            });
+        }
+    });
+    manager.run();
+}
+
+int main()
+{
+    {
+        counter_t      counter0{0, 0};
+        counter_t      counter1{0, 0};
+        thread_manager manager;
+
+        manager.queue_loop_n([&] { increment(domain0, counter0); }, loop_count);
+        manager.queue_loop_n([&] { increment(domain0, counter0); }, loop_count);
+        manager.queue_loop_n([&] { increment(domain1, counter1); }, loop_count);
+        manager.queue_loop_n([&] { increment(domain1, counter1); }, loop_count);
+        manager.queue_loop_n(
+            [&] {
+                lstm::read_only(domain0, [&](const lstm::read_transaction tx) {
+                    const auto& value = counter0.get(tx);
+                    CHECK(value.first == value.second);
+                });
+            },
+            loop_count);
+
+        manager.run();
+
+        CHECK(counter0.unsafe_get() == std::make_pair(loop_count * 2, loop_count * 2));
+        CHECK(counter1.unsafe_get() == std::make_pair(loop_count * 2, loop_count * 2));
+        CHECK(domain0.get_clock() == lstm::epoch_t(loop_count * 2));
+        CHECK(domain1.get_clock() == lstm::epoch_t(loop_count * 2));
+        CHECK(lstm::default_domain().get_clock() == 0u);
+    }
+    {
+        lstm::list<int, debug_alloc<int>> ints{domain1};
+        CHECK(&ints.domain() == &domain1);
+
+        thread_manager manager;
+
+        manager.queue_loop_n([&] { ints.emplace_front(0); }, loop_count);
+        manager.queue_loop_n([&] { lstm::atomic(domain1, [&] { ints.emplace_front(0); }); },
+                             loop_count);
+        manager.queue_loop_n([&] { ints.clear(); }, loop_count / 10);
+
+        manager.run();
+    }
+    CHECK(debug_live_allocations<> == 0);
+
+    destroyed_domain();
+    CHECK(debug_live_allocations<> == 0);
+
+    return test_result();
+}
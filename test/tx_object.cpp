@@ -0,0 +1,195 @@
+#include <lstm/lstm.hpp>
+
+#include "simple_test.hpp"
+#include "thread_manager.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+static constexpr int loop_count   = LSTM_TEST_INIT(50000, 500);
+static constexpr int thread_count = 4;
+
+using point = lstm::tx_object<int, int, std::string>;
+
+#ifndef LSTM_NOREC
+static lstm::transaction_domain etl_domain{lstm::locking_mode::encounter_time};
+#endif
+
+// the thread frees the fields it replaced as it exits, which waits for any transaction running here
+// to end. so it is joined by the caller, once outside of the transaction
+static std::thread commit_on_other_thread(point& p)
+{
+    std::atomic<bool> done{false};
+    std::thread       other{[&] {
+        lstm::atomic([&](const lstm::transaction tx) { p.set<2>(tx, std::string("other")); });
+        done.store(true);
+    }};
+    while (!done.load())
+        std::this_thread::yield();
+    return other;
+}
+
+// fields are read and written one at a time, and the rest are left as they were
+static void fields()
+{
+    point p{1, 2, "three"};
+    CHECK(p.unsafe_get<0>() == 1);
+    CHECK(p.unsafe_get<2>() == "three");
+
+    lstm::atomic([&](const lstm::transaction tx) {
+        CHECK(p.get<1>(tx) == 2);
+        p.set<0>(tx, 10);
+        p.set<1>(tx, p.get<0>(tx) + 10);
+        CHECK(p.get<0>(tx) == 10);
+        CHECK(p.get<2>(tx) == "three");
+    });
+    CHECK(p.unsafe_get() == std::make_tuple(10, 20, std::string("three")));
+
+    lstm::atomic([&](const lstm::transaction tx) {
+        p.update(tx, [](point::fields_type& f) {
+            std::get<0>(f) = 100;
+            std::get<2>(f) += "!";
+        });
+    });
+    CHECK(p.unsafe_get() == std::make_tuple(100, 20, std::string("three!")));
+
+    const int sum = lstm::atomic(
+        [&](const lstm::read_transaction tx) { return p.get<0>(tx) + p.get<1>(tx); });
+    CHECK(sum == 120);
+
+    p.unsafe_set<1>(0);
+    CHECK(p.unsafe_get() == std::make_tuple(100, 0, std::string("three!")));
+}
+
+struct counted
+{
+    static int copies;
+    int        value;
+
+    counted(const int in_value = 0) noexcept
+        : value(in_value)
+    {
+    }
+
+    counted(const counted& rhs) noexcept
+        : value(rhs.value)
+    {
+        ++copies;
+    }
+
+    counted(counted&&) noexcept = default;
+
+    counted& operator=(const counted& rhs) noexcept
+    {
+        value = rhs.value;
+        ++copies;
+        return *this;
+    }
+
+    counted& operator=(counted&&) noexcept = default;
+};
+
+int counted::copies = 0;
+
+// only the first write in a transaction copies the fields. later writes change that copy in place
+static void copies_once(lstm::transaction_domain& domain)
+{
+    lstm::tx_object<counted, int> o{counted{}, 0};
+    counted::copies = 0;
+    lstm::atomic(domain, [&](const lstm::transaction tx) {
+        const counted* const first = &o.get<0>(tx);
+        for (int i = 1; i <= 10; ++i)
+            o.set<1>(tx, i);
+        o.update(tx, [](lstm::tx_object<counted, int>::fields_type& f) {
+            std::get<0>(f).value = 42;
+        });
+        CHECK(&o.get<0>(tx) != first);
+        CHECK(o.get<0>(tx).value == 42);
+        CHECK(o.get<1>(tx) == 10);
+    });
+    CHECK(counted::copies == 1);
+    CHECK(o.unsafe_get<0>().value == 42);
+    CHECK(o.unsafe_get<1>() == 10);
+}
+
+// the fields share one version lock, so a write to any of them conflicts with a read of another
+static void shared_lock()
+{
+    point       p{0, 0, ""};
+    int         attempts = 0;
+    std::thread other;
+    lstm::atomic([&](const lstm::transaction tx) {
+        const int x = p.get<0>(tx);
+        if (++attempts == 1)
+            other = commit_on_other_thread(p);
+        p.set<1>(tx, x + 1);
+    });
+    other.join();
+    CHECK(attempts == 2);
+    CHECK(p.unsafe_get() == std::make_tuple(0, 1, std::string("other")));
+
+    bool exhausted = false;
+    try {
+        lstm::atomic(lstm::with_attempt_limit(1, [&](const lstm::transaction tx) {
+            p.get<1>(tx);
+            other = commit_on_other_thread(p);
+            p.get<0>(tx);
+        }));
+    } catch (const lstm::budget_exhausted& e) {
+        exhausted = true;
+#ifndef LSTM_NOREC
+        CHECK(e.info.cause == lstm::abort_cause::read_conflict);
+        CHECK(p.caused(e.info));
+#endif
+    }
+    other.join();
+    CHECK(exhausted);
+}
+
+// fields written together are never seen apart
+static void threads()
+{
+    point          p{0, 0, ""};
+    thread_manager manager;
+
+    for (int i = 0; i < thread_count; ++i) {
+        manager.queue_loop_n(
+            [&] {
+                lstm::atomic([&](const lstm::transaction tx) {
+                    const int x = p.get<0>(tx) + 1;
+                    p.set<0>(tx, x);
+                    p.set<1>(tx, -x);
+                });
+                lstm::atomic([&](const lstm::read_transaction tx) {
+                    const int sum = p.get<0>(tx) + p.get<1>(tx);
+                    CHECK(sum == 0);
+                });
+            },
+            loop_count);
+    }
+
+    manager.run();
+
+    CHECK(p.unsafe_get<0>() == thread_count * loop_count);
+    CHECK(p.unsafe_get<1>() == -thread_count * loop_count);
+}
+
+int main()
+{
+    {
+        thread_manager manager;
+        manager.queue_thread([] {
+            fields();
+            copies_once(lstm::default_domain());
+#ifndef LSTM_NOREC
+            copies_once(etl_domain);
+#endif
+            shared_lock();
+        });
+        manager.run();
+    }
+    threads();
+
+    return test_result();
+}